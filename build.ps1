@@ -44,18 +44,32 @@ $srcFiles = @(
     'src/Config.cpp',
     'src/EventManager.cpp',
     'src/EntityManager.cpp',
+    'src/EntityWorld.cpp',
     'src/ChunkManager.cpp',
     'src/Chunk.cpp',
+    'src/ChunkStore.cpp',
+    'src/ChunkOctree.cpp',
+    'src/ChunkPath.cpp',
+    'src/ChunkOcclusion.cpp',
+    'src/ThreadPool.cpp',
     'src/GreedyMesher.cpp',
     'src/HeightmapGenerator.cpp',
+    'src/ColumnCache.cpp',
+    'src/GenerationPipeline.cpp',
+    'src/GenerationStages.cpp',
+    'src/PerlinNoise.cpp',
+    'src/Benchmarks.cpp',
     'src/AssetManager.cpp',
     'src/Input.cpp',
     'src/DebugHud.cpp',
     'src/PhysicsSystem.cpp',
     'src/SystemManager.cpp',
     'src/CollisionSystem.cpp',
+    'src/BroadPhase.cpp',
     'src/Log.cpp',
-    'src/ArchetypeManager.cpp'
+    'src/ArchetypeManager.cpp',
+    'src/ArchetypeCache.cpp',
+    'src/ArchetypeWatcher.cpp'
 )
 
 $includeArgs = '-Isrc -Isrc\include'
@@ -1,13 +1,20 @@
 #pragma once
 #include "include/raylib.h"
+#include <cstdint>
 #include <string>
 
+// Stable index of a loaded archetype (ArchetypeManager::FindArchetypeId); resolve
+// a name once and reuse the id instead of looking the string up per spawn
+using ArchetypeId = uint32_t;
+constexpr ArchetypeId INVALID_ARCHETYPE = UINT32_MAX;
+
 // A data container for an entity
 struct Archetype {
     std::string tag;
     std::string model_id;
     Color color = WHITE;
     Vector3 velocity = {};
+    std::string parent; // name given to `inherits`, empty for a root
     std::string source_path;
     
     bool populated = false;
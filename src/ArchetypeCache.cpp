@@ -0,0 +1,377 @@
+#include "ArchetypeCache.h"
+#include "Config.h"
+#include "Log.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr char CACHE_MAGIC[4] = { 'G', 'A', 'R', 'C' };
+    constexpr uint32_t CACHE_VERSION = 3;
+
+    // Layout: Header, SourceRecord[sourceCount + inheritedCount], EntryRecord[entryCount],
+    // then the string bytes that StrRefs point into. The inherited sources
+    // follow the directory's own and are named by path rather than file name. Native byte order; the cache is
+    // a local build artifact, not a file to share between machines.
+    struct StrRef {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t sourceCount;
+        uint32_t inheritedCount;
+        uint32_t entryCount;
+        uint32_t pad;
+        uint64_t stringBytes;
+    };
+
+    struct SourceRecord {
+        StrRef name;
+        uint32_t pad;
+        uint64_t size;
+        int64_t mtime;
+        uint64_t hash;
+    };
+
+    struct EntryRecord {
+        StrRef key;
+        StrRef tag;
+        StrRef model;
+        StrRef parent;
+        StrRef source;
+        uint8_t color[4];
+        float velocity[3];
+        uint32_t populated;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Header> && std::is_trivially_copyable_v<SourceRecord> &&
+                  std::is_trivially_copyable_v<EntryRecord>);
+
+    struct Source {
+        std::string name; // file name within the directory, or path for inherited files
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        fs::path path;
+    };
+
+    uint64_t Fnv1a(const void* data, size_t size, uint64_t h = 14695981039346656037ull) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    bool HashFile(const fs::path& path, uint64_t& hash) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) return false;
+        hash = 14695981039346656037ull;
+        char buf[16384];
+        while (file) {
+            file.read(buf, sizeof(buf));
+            hash = Fnv1a(buf, static_cast<size_t>(file.gcount()), hash);
+        }
+        return true;
+    }
+
+    // The directory's .archetype files, sorted by name
+    bool ListSources(const std::string& directoryPath, std::vector<Source>& out) {
+        std::error_code ec;
+        fs::directory_iterator it(directoryPath, ec);
+        if (ec) return false;
+        for (; it != fs::directory_iterator(); it.increment(ec)) {
+            if (ec) return false;
+            const fs::directory_entry& entry = *it;
+            if (!entry.is_regular_file(ec) || entry.path().extension() != ".archetype") continue;
+            Source s;
+            s.path = entry.path();
+            s.name = entry.path().filename().string();
+            s.size = static_cast<uint64_t>(entry.file_size(ec));
+            s.mtime = static_cast<int64_t>(entry.last_write_time(ec).time_since_epoch().count());
+            if (ec) return false;
+            out.push_back(std::move(s));
+        }
+        std::sort(out.begin(), out.end(), [](const Source& a, const Source& b) { return a.name < b.name; });
+        return true;
+    }
+
+    // One file outside the directory, named by the path it was loaded from
+    bool StatSource(const std::string& path, Source& out) {
+        std::error_code ec;
+        out.path = fs::path(path);
+        out.name = path;
+        out.size = static_cast<uint64_t>(fs::file_size(out.path, ec));
+        if (ec) return false;
+        out.mtime = static_cast<int64_t>(fs::last_write_time(out.path, ec).time_since_epoch().count());
+        return !ec;
+    }
+
+    fs::path CachePath(const std::string& cacheDir, const std::string& directoryPath) {
+        std::error_code ec;
+        fs::path dir = fs::weakly_canonical(fs::path(directoryPath), ec);
+        const std::string key = ec ? directoryPath : dir.string();
+        char name[48];
+        std::snprintf(name, sizeof(name), "archetypes-%016llx.bin",
+                      static_cast<unsigned long long>(Fnv1a(key.data(), key.size())));
+        return fs::path(cacheDir) / name;
+    }
+
+    // Read-only view of a whole file: mapped where mmap exists, read into memory otherwise
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ~MappedFile() {
+#if defined(__linux__)
+            if (map) munmap(map, size);
+#endif
+        }
+
+        bool Open(const fs::path& path) {
+#if defined(__linux__)
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) return false;
+            struct stat st;
+            if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+                ::close(fd);
+                return false;
+            }
+            size = static_cast<size_t>(st.st_size);
+            void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd); // the mapping keeps the file contents reachable
+            if (p == MAP_FAILED) return false;
+            map = p;
+            data = static_cast<const unsigned char*>(p);
+            return true;
+#else
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file.is_open()) return false;
+            const std::streamsize length = file.tellg();
+            if (length <= 0) return false;
+            buffer.resize(static_cast<size_t>(length));
+            file.seekg(0);
+            if (!file.read(reinterpret_cast<char*>(buffer.data()), length)) return false;
+            data = buffer.data();
+            size = buffer.size();
+            return true;
+#endif
+        }
+
+        const unsigned char* Data() const { return data; }
+        size_t Size() const { return size; }
+
+    private:
+        const unsigned char* data = nullptr;
+        size_t size = 0;
+#if defined(__linux__)
+        void* map = nullptr;
+#else
+        std::vector<unsigned char> buffer;
+#endif
+    };
+
+    // Bounds-checked reads from the cache blob
+    struct Reader {
+        const unsigned char* data;
+        size_t size;
+        size_t stringsAt = 0;
+        uint64_t stringBytes = 0;
+
+        template <class T>
+        bool Read(size_t offset, T& out) const {
+            if (offset > size || size - offset < sizeof(T)) return false;
+            std::memcpy(&out, data + offset, sizeof(T));
+            return true;
+        }
+
+        bool String(const StrRef& ref, std::string& out) const {
+            if (static_cast<uint64_t>(ref.offset) + ref.length > stringBytes) return false;
+            out.assign(reinterpret_cast<const char*>(data + stringsAt + ref.offset), ref.length);
+            return true;
+        }
+    };
+}
+
+std::string ArchetypeCache::GetCacheDir() {
+    return Config::GetString("archetypes.cache_dir", "build/cache");
+}
+
+bool ArchetypeCache::Load(const std::string& directoryPath, std::vector<Entry>& out) {
+    const std::string cacheDir = GetCacheDir();
+    if (cacheDir.empty()) return false;
+
+    MappedFile file;
+    if (!file.Open(CachePath(cacheDir, directoryPath))) return false;
+
+    Reader r{ file.Data(), file.Size() };
+    Header header;
+    if (!r.Read(0, header) || std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header.version != CACHE_VERSION) {
+        Log::Debug("ArchetypeCache: ignoring unrecognized cache for " + directoryPath);
+        return false;
+    }
+    const size_t sourcesAt = sizeof(Header);
+    const size_t sourceTotal = static_cast<size_t>(header.sourceCount) + header.inheritedCount;
+    const size_t entriesAt = sourcesAt + sourceTotal * sizeof(SourceRecord);
+    r.stringsAt = entriesAt + static_cast<size_t>(header.entryCount) * sizeof(EntryRecord);
+    r.stringBytes = header.stringBytes;
+    if (r.stringsAt > r.size || r.size - r.stringsAt < header.stringBytes) return false;
+
+    // Same files with the same size and mtime are trusted as-is. A file whose
+    // mtime moved but whose bytes hash the same (checked out again, touched)
+    // still counts as unchanged.
+    std::vector<Source> sources;
+    if (!ListSources(directoryPath, sources) || sources.size() != header.sourceCount) return false;
+    bool touched = false;
+    auto unchanged = [&r, &touched](size_t offset, const Source& s) {
+        SourceRecord rec;
+        std::string name;
+        if (!r.Read(offset, rec) || !r.String(rec.name, name)) return false;
+        if (name != s.name || rec.size != s.size) return false;
+        if (rec.mtime != s.mtime) {
+            uint64_t hash = 0;
+            if (!HashFile(s.path, hash) || hash != rec.hash) return false;
+            touched = true;
+        }
+        return true;
+    };
+    for (size_t i = 0; i < sources.size(); ++i) {
+        if (!unchanged(sourcesAt + i * sizeof(SourceRecord), sources[i])) return false;
+    }
+    std::vector<std::string> inheritedFrom;
+    for (size_t i = header.sourceCount; i < sourceTotal; ++i) {
+        const size_t offset = sourcesAt + i * sizeof(SourceRecord);
+        SourceRecord rec;
+        Source s;
+        if (!r.Read(offset, rec) || !r.String(rec.name, s.name) || !StatSource(s.name, s) || !unchanged(offset, s)) return false;
+        inheritedFrom.push_back(s.name);
+    }
+
+    out.clear();
+    out.reserve(header.entryCount);
+    for (size_t i = 0; i < header.entryCount; ++i) {
+        EntryRecord rec;
+        Entry e;
+        if (!r.Read(entriesAt + i * sizeof(EntryRecord), rec) || !r.String(rec.key, e.key) ||
+            !r.String(rec.tag, e.archetype.tag) || !r.String(rec.model, e.archetype.model_id) ||
+            !r.String(rec.parent, e.archetype.parent) || !r.String(rec.source, e.archetype.source_path)) {
+            out.clear();
+            return false;
+        }
+        e.archetype.color = Color{ rec.color[0], rec.color[1], rec.color[2], rec.color[3] };
+        e.archetype.velocity = Vector3{ rec.velocity[0], rec.velocity[1], rec.velocity[2] };
+        e.archetype.populated = rec.populated != 0;
+        out.push_back(std::move(e));
+    }
+    // Record the new mtimes so the next start doesn't hash those files again
+    if (touched) Save(directoryPath, out, inheritedFrom);
+    return true;
+}
+
+void ArchetypeCache::Save(const std::string& directoryPath, const std::vector<Entry>& entries,
+                          const std::vector<std::string>& inheritedFrom) {
+    const std::string cacheDir = GetCacheDir();
+    if (cacheDir.empty()) return;
+
+    std::vector<Source> sources;
+    if (!ListSources(directoryPath, sources) || sources.empty()) return;
+    const size_t ownSources = sources.size();
+    for (const std::string& path : inheritedFrom) {
+        Source s;
+        if (!StatSource(path, s)) return; // can't vouch for it next time, so don't cache
+        sources.push_back(std::move(s));
+    }
+
+    std::string strings;
+    auto addString = [&strings](const std::string& s) {
+        StrRef ref{ static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(s.size()) };
+        strings += s;
+        return ref;
+    };
+
+    std::vector<SourceRecord> sourceRecs;
+    sourceRecs.reserve(sources.size());
+    for (const Source& s : sources) {
+        SourceRecord rec{};
+        rec.name = addString(s.name);
+        rec.size = s.size;
+        rec.mtime = s.mtime;
+        if (!HashFile(s.path, rec.hash)) return;
+        sourceRecs.push_back(rec);
+    }
+
+    std::vector<EntryRecord> entryRecs;
+    entryRecs.reserve(entries.size());
+    for (const Entry& e : entries) {
+        const Archetype& a = e.archetype;
+        EntryRecord rec{};
+        rec.key = addString(e.key);
+        rec.tag = addString(a.tag);
+        rec.model = addString(a.model_id);
+        rec.parent = addString(a.parent);
+        rec.source = addString(a.source_path);
+        rec.color[0] = a.color.r;
+        rec.color[1] = a.color.g;
+        rec.color[2] = a.color.b;
+        rec.color[3] = a.color.a;
+        rec.velocity[0] = a.velocity.x;
+        rec.velocity[1] = a.velocity.y;
+        rec.velocity[2] = a.velocity.z;
+        rec.populated = a.populated ? 1u : 0u;
+        entryRecs.push_back(rec);
+    }
+
+    Header header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.sourceCount = static_cast<uint32_t>(ownSources);
+    header.inheritedCount = static_cast<uint32_t>(sourceRecs.size() - ownSources);
+    header.entryCount = static_cast<uint32_t>(entryRecs.size());
+    header.stringBytes = strings.size();
+
+    std::error_code ec;
+    fs::create_directories(cacheDir, ec);
+    const fs::path path = CachePath(cacheDir, directoryPath);
+    // Write beside the cache and swap it in, so a crash never leaves half a file
+    fs::path tmp = path;
+    tmp += ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            Log::Warning("ArchetypeCache: failed to write " + tmp.string());
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(sourceRecs.data()), sourceRecs.size() * sizeof(SourceRecord));
+        file.write(reinterpret_cast<const char*>(entryRecs.data()), entryRecs.size() * sizeof(EntryRecord));
+        file.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+        if (!file) {
+            Log::Warning("ArchetypeCache: failed to write " + tmp.string());
+            return;
+        }
+    }
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        Log::Warning("ArchetypeCache: failed to replace " + path.string() + ": " + ec.message());
+        fs::remove(tmp, ec);
+        return;
+    }
+    Log::Debug("ArchetypeCache: compiled " + std::to_string(entries.size()) + " archetypes from " + directoryPath);
+}
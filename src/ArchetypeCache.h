@@ -0,0 +1,30 @@
+#pragma once
+#include "Archetype.h"
+#include <string>
+#include <vector>
+
+// Compiled archetype database. After a directory is parsed, every archetype it
+// produced (already flattened through `inherits`) is written to one binary file
+// together with a fingerprint of the directory's .archetype files: name, size,
+// mtime and content hash. On the next start an unchanged directory is mapped
+// and its records copied out without touching the text files; any added,
+// removed or edited source sends that directory back through the parser.
+// Parents found in the same directory are covered by that key; archetypes
+// inherited from files loaded out of other directories are fingerprinted
+// alongside, so editing one of those also sends the directory back.
+namespace ArchetypeCache {
+    struct Entry {
+        std::string key; // ArchetypeManager map key
+        Archetype archetype;
+    };
+
+    // Cache directory from archetypes.cache_dir; empty turns caching off
+    std::string GetCacheDir();
+
+    // Entries compiled for directoryPath, if the cache exists and its sources are unchanged
+    bool Load(const std::string& directoryPath, std::vector<Entry>& out);
+    // Record what parsing directoryPath produced; inheritedFrom lists the files
+    // outside the directory that its archetypes inherit from
+    void Save(const std::string& directoryPath, const std::vector<Entry>& entries,
+              const std::vector<std::string>& inheritedFrom);
+}
@@ -1,10 +1,12 @@
 #include "ArchetypeManager.h"
+#include "ArchetypeCache.h"
 #include "Log.h"
 #include "include/raylib.h"
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <string>
 #include <cctype>
-// <algorithm> removed because it's not needed and causes editor warnings
 
 // Provide a single, global instance
 ArchetypeManager& ArchetypeManager::GetInstance() {
@@ -23,10 +25,32 @@ static std::string trim(const std::string& s) {
     return std::string(start, end + 1);
 }
 
-// Scans a directory and commands the parser to load each file
+// Directory portion of a path, without the trailing separator
+static std::string directoryOf(const std::string& path) {
+    size_t pos = path.find_last_of("/\\");
+    return pos == std::string::npos ? std::string() : path.substr(0, pos);
+}
+
+// Scans a directory and commands the parser to load each file, unless the
+// compiled cache for the directory is still current
 void ArchetypeManager::LoadArchetypesFromDirectory(const std::string& directoryPath) {
     Log::Info("Scanning for archetypes in: " + directoryPath);
     current_directory = directoryPath; // Store the path for use in recursive calls
+
+    auto start = std::chrono::steady_clock::now();
+    auto elapsedMs = [&start]() {
+        return std::to_string(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    };
+
+    std::vector<ArchetypeCache::Entry> cached;
+    if (ArchetypeCache::Load(directoryPath, cached)) {
+        for (const ArchetypeCache::Entry& e : cached) StoreArchetype(e.key, e.archetype);
+        Log::Info("Loaded " + std::to_string(cached.size()) + " compiled archetypes in " + elapsedMs() + " ms");
+        return;
+    }
+
+    Recording stored;
+    recording = &stored;
     FilePathList files = LoadDirectoryFiles(directoryPath.c_str());
 
     for (unsigned int i = 0; i < files.count; i++) {
@@ -41,6 +65,45 @@ void ArchetypeManager::LoadArchetypesFromDirectory(const std::string& directoryP
         }
     }
     UnloadDirectoryFiles(files);
+    recording = nullptr;
+
+    // Compile what this directory produced (in first-stored order) for next time
+    std::vector<ArchetypeCache::Entry> compiled;
+    std::unordered_set<std::string> seen;
+    for (const std::string& key : stored.keys) {
+        auto it = archetypes.find(key);
+        if (it == archetypes.end() || !seen.insert(key).second) continue;
+        compiled.push_back(ArchetypeCache::Entry{ key, it->second });
+    }
+    std::sort(stored.inheritedFrom.begin(), stored.inheritedFrom.end());
+    stored.inheritedFrom.erase(std::unique(stored.inheritedFrom.begin(), stored.inheritedFrom.end()), stored.inheritedFrom.end());
+    ArchetypeCache::Save(directoryPath, compiled, stored.inheritedFrom);
+    Log::Info("Parsed " + std::to_string(compiled.size()) + " archetypes in " + elapsedMs() + " ms");
+}
+
+// Insert or replace a map entry. A key already taken by a different source file is kept.
+bool ArchetypeManager::StoreArchetype(const std::string& key, const Archetype& a) {
+    auto existing = archetypes.find(key);
+    if (existing != archetypes.end() && existing->second.source_path != a.source_path) {
+        Log::Warning("Skipping archetype '" + key + "' from '" + a.source_path + "' because a different archetype with the same key already exists from '" + existing->second.source_path + "'");
+        return false;
+    }
+    archetypes[key] = a;
+    if (recording) recording->keys.push_back(key);
+    return true;
+}
+
+// The parent and everything it inherits from, as far as they were loaded from
+// another directory than the child
+void ArchetypeManager::RecordInheritedFrom(const std::string& childPath, const Archetype& parent) {
+    const std::string dir = directoryOf(childPath);
+    const Archetype* a = &parent;
+    for (int depth = 0; a && depth < 64; ++depth) {
+        if (!a->source_path.empty() && directoryOf(a->source_path) != dir) recording->inheritedFrom.push_back(a->source_path);
+        if (a->parent.empty()) break;
+        auto it = archetypes.find(a->parent);
+        a = it != archetypes.end() ? &it->second : nullptr;
+    }
 }
 
 // Get a pointer to a loaded archetype by its name
@@ -52,6 +115,30 @@ Archetype* ArchetypeManager::GetArchetype(const std::string& name) {
     return nullptr;
 }
 
+ArchetypeId ArchetypeManager::FindArchetypeId(const std::string& name) {
+    auto known = ids.find(name);
+    if (known != ids.end()) return known->second;
+    auto it = archetypes.find(name);
+    if (it == archetypes.end()) {
+        Log::Warning("Archetype not found: " + name);
+        return INVALID_ARCHETYPE;
+    }
+    ArchetypeId id = static_cast<ArchetypeId>(by_id.size());
+    by_id.push_back(&it->second);
+    id_names.push_back(name);
+    ids.emplace(name, id);
+    return id;
+}
+
+Archetype* ArchetypeManager::GetArchetype(ArchetypeId id) {
+    return id < by_id.size() ? by_id[id] : nullptr;
+}
+
+const std::string& ArchetypeManager::GetArchetypeName(ArchetypeId id) const {
+    static const std::string unknown;
+    return id < id_names.size() ? id_names[id] : unknown;
+}
+
 // Public entry that initializes cycle detection state
 Archetype ArchetypeManager::LoadFile(const std::string& filepath) {
     std::unordered_set<std::string> loading;
@@ -64,7 +151,8 @@ bool ArchetypeManager::LoadFileToMap(const std::string& filepath) {
         return false;
     }
     // Use lightweight filename extraction to avoid relying on std::filesystem
-    std::string mapKey = GetFileNameWithoutExt(filepath.c_str());
+    const std::string fileKey = GetFileNameWithoutExt(filepath.c_str());
+    std::string mapKey = fileKey;
 
     // Prefer the archetype's tag as the map key when available (so files like cube_base.archetype
     // that declare tag: cube are stored under 'cube')
@@ -72,20 +160,13 @@ bool ArchetypeManager::LoadFileToMap(const std::string& filepath) {
         mapKey = a.tag;
     }
 
-    a.source_path = filepath;
-
-    auto existing = archetypes.find(mapKey);
-    if (existing != archetypes.end()) {
-        if (existing->second.source_path == a.source_path) {
-            archetypes[mapKey] = a;
-        } else {
-            Log::Warning("Skipping archetype '" + mapKey + "' from '" + a.source_path + "' because a different archetype with the same key already exists from '" + existing->second.source_path + "'");
-            return false;
-        }
-    } else {
-        archetypes[mapKey] = a;
+    // LoadFileInternal already stored the file-name key (with a.source_path, the
+    // resolved path it opened) through StoreArchetype
+    if (mapKey == fileKey) {
+        auto it = archetypes.find(mapKey);
+        return it != archetypes.end() && it->second.source_path == a.source_path;
     }
-    return true;
+    return StoreArchetype(mapKey, a);
 }
 
 // Internal implementation with cycle detection
@@ -120,7 +201,7 @@ Archetype ArchetypeManager::LoadFileInternal(const std::string& filepath, std::u
     }
 
     std::string name = GetFileNameWithoutExt(filepathStr.c_str());
-    Log::Info("Parsing archetype: " + name);
+    Log::Debug("Parsing archetype: " + name);
 
     // If we're already loading this archetype, abort to avoid cycles
     if (loading.find(filepathStr) != loading.end()) {
@@ -165,46 +246,46 @@ Archetype ArchetypeManager::LoadFileInternal(const std::string& filepath, std::u
             try {
                 child.color.r = static_cast<unsigned char>(std::stoi(value));
                 flags.color_r = true; child.populated = true;
-                if (child.color.r == WHITE.r) Log::Info("Archetype '" + name + "' explicitly sets color_r to white (default)");
+                if (child.color.r == WHITE.r) Log::Debug("Archetype '" + name + "' explicitly sets color_r to white (default)");
             } catch (...) { Log::Warning("Invalid color_r for " + name + ", value='" + value + "'"); }
         }
         else if (key == "color_g") {
             try {
                 child.color.g = static_cast<unsigned char>(std::stoi(value));
                 flags.color_g = true; child.populated = true;
-                if (child.color.g == WHITE.g) Log::Info("Archetype '" + name + "' explicitly sets color_g to white (default)");
+                if (child.color.g == WHITE.g) Log::Debug("Archetype '" + name + "' explicitly sets color_g to white (default)");
             } catch (...) { Log::Warning("Invalid color_g for " + name + ", value='" + value + "'"); }
         }
         else if (key == "color_b") {
             try {
                 child.color.b = static_cast<unsigned char>(std::stoi(value));
                 flags.color_b = true; child.populated = true;
-                if (child.color.b == WHITE.b) Log::Info("Archetype '" + name + "' explicitly sets color_b to white (default)");
+                if (child.color.b == WHITE.b) Log::Debug("Archetype '" + name + "' explicitly sets color_b to white (default)");
             } catch (...) { Log::Warning("Invalid color_b for " + name + ", value='" + value + "'"); }
         }
         else if (key == "color_a") {
             try {
                 child.color.a = static_cast<unsigned char>(std::stoi(value));
                 flags.color_a = true; child.populated = true;
-                if (child.color.a == WHITE.a) Log::Info("Archetype '" + name + "' explicitly sets color_a to white (default)");
+                if (child.color.a == WHITE.a) Log::Debug("Archetype '" + name + "' explicitly sets color_a to white (default)");
             } catch (...) { Log::Warning("Invalid color_a for " + name + ", value='" + value + "'"); }
         }
         else if (key == "velocity_x") {
             try {
                 child.velocity.x = std::stof(value); flags.vel_x = true; child.populated = true;
-                if (child.velocity.x == 0.0f) Log::Info("Archetype '" + name + "' explicitly sets velocity_x to 0.0 (default)");
+                if (child.velocity.x == 0.0f) Log::Debug("Archetype '" + name + "' explicitly sets velocity_x to 0.0 (default)");
             } catch (...) { Log::Warning("Invalid velocity_x for " + name + ", value='" + value + "'"); }
         }
         else if (key == "velocity_y") {
             try {
                 child.velocity.y = std::stof(value); flags.vel_y = true; child.populated = true;
-                if (child.velocity.y == 0.0f) Log::Info("Archetype '" + name + "' explicitly sets velocity_y to 0.0 (default)");
+                if (child.velocity.y == 0.0f) Log::Debug("Archetype '" + name + "' explicitly sets velocity_y to 0.0 (default)");
             } catch (...) { Log::Warning("Invalid velocity_y for " + name + ", value='" + value + "'"); }
         }
         else if (key == "velocity_z") {
             try {
                 child.velocity.z = std::stof(value); flags.vel_z = true; child.populated = true;
-                if (child.velocity.z == 0.0f) Log::Info("Archetype '" + name + "' explicitly sets velocity_z to 0.0 (default)");
+                if (child.velocity.z == 0.0f) Log::Debug("Archetype '" + name + "' explicitly sets velocity_z to 0.0 (default)");
             } catch (...) { Log::Warning("Invalid velocity_z for " + name + ", value='" + value + "'"); }
         }
     }
@@ -218,8 +299,11 @@ Archetype ArchetypeManager::LoadFileInternal(const std::string& filepath, std::u
     // If we have a parent, try to load it (search in same directory as this file)
     if (!parentName.empty()) {
         // Prefer already-loaded parent
-        if (archetypes.find(parentName) != archetypes.end()) {
-            result = archetypes.at(parentName);
+        auto loaded = archetypes.find(parentName);
+        if (loaded != archetypes.end()) {
+            result = loaded->second;
+            // Possibly from another directory, which this directory's cache key doesn't cover
+            if (recording) RecordInheritedFrom(filepathStr, loaded->second);
         } else {
             // Compute parent path by joining directory of filepathStr with the parent name
             size_t pos = filepathStr.find_last_of("/\\");
@@ -252,15 +336,117 @@ Archetype ArchetypeManager::LoadFileInternal(const std::string& filepath, std::u
         result.populated = true;
     }
 
+    result.parent = parentName;
     result.source_path = filepathStr;
 
     // Finished loading this archetype
     loading.erase(filepathStr);
 
-    archetypes[name] = result;
+    StoreArchetype(name, result);
     return result;
 }
 
+static bool SameArchetype(const Archetype& a, const Archetype& b) {
+    return a.tag == b.tag && a.model_id == b.model_id && a.parent == b.parent && a.populated == b.populated &&
+           a.color.r == b.color.r && a.color.g == b.color.g && a.color.b == b.color.b && a.color.a == b.color.a &&
+           a.velocity.x == b.velocity.x && a.velocity.y == b.velocity.y && a.velocity.z == b.velocity.z;
+}
+
+std::vector<std::string> ArchetypeManager::ExpandReload(const std::vector<std::string>& fileNames) const {
+    // Who inherits from whom, by file stem. `inherits` may name the parent by
+    // its tag, so go through the parent archetype to the file it came from.
+    std::unordered_map<std::string, std::vector<std::string>> childrenByStem;
+    for (const auto& [key, a] : archetypes) {
+        std::string stem = GetFileNameWithoutExt(a.source_path.c_str());
+        if (a.parent.empty() || key != stem) continue;
+        auto parent = archetypes.find(a.parent);
+        if (parent == archetypes.end()) continue;
+        childrenByStem[GetFileNameWithoutExt(parent->second.source_path.c_str())].push_back(stem);
+    }
+
+    // The changed files and all their descendants (breadth-first)
+    std::vector<std::string> order;
+    std::unordered_set<std::string> affected;
+    for (const std::string& file : fileNames) {
+        std::string stem = GetFileNameWithoutExt(file.c_str());
+        if (affected.insert(stem).second) order.push_back(stem);
+    }
+    for (size_t i = 0; i < order.size(); ++i) {
+        auto it = childrenByStem.find(order[i]);
+        if (it == childrenByStem.end()) continue;
+        for (const std::string& child : it->second) {
+            if (affected.insert(child).second) order.push_back(child);
+        }
+    }
+
+    // Parents before children: a child is re-merged from its already reloaded parent
+    auto depth = [this](const std::string& stem) {
+        int d = 0;
+        for (auto it = archetypes.find(stem); it != archetypes.end() && !it->second.parent.empty() && d < 64; ++d) {
+            it = archetypes.find(it->second.parent);
+        }
+        return d;
+    };
+    std::vector<std::pair<int, std::string>> byDepth;
+    for (const std::string& stem : order) byDepth.emplace_back(depth(stem), stem);
+    std::stable_sort(byDepth.begin(), byDepth.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<std::string> files;
+    files.reserve(byDepth.size());
+    for (const auto& [d, stem] : byDepth) files.push_back(stem + ".archetype");
+    return files;
+}
+
+std::vector<ArchetypeId> ArchetypeManager::ReloadFiles(const std::string& directoryPath, const std::vector<std::string>& fileNames) {
+    std::vector<ArchetypeId> changed;
+    current_directory = directoryPath;
+
+    // Map keys by the file (stem) they came from: the file-name key and, for
+    // tagged archetypes, the tag key
+    std::unordered_map<std::string, std::vector<std::string>> keysByStem;
+    for (const auto& [key, a] : archetypes) {
+        keysByStem[GetFileNameWithoutExt(a.source_path.c_str())].push_back(key);
+    }
+
+    std::string sep = (!directoryPath.empty() && (directoryPath.back() == '/' || directoryPath.back() == '\\')) ? "" : "/";
+    for (const std::string& file : fileNames) {
+        const std::string stem = GetFileNameWithoutExt(file.c_str());
+        const std::string path = directoryPath + sep + stem + ".archetype";
+        auto known = keysByStem.find(stem);
+
+        if (!FileExists(path.c_str())) {
+            if (known != keysByStem.end()) Log::Warning("Archetype file removed: " + path + " (keeping its last loaded version)");
+            continue;
+        }
+        if (known == keysByStem.end()) {
+            LoadFileToMap(stem + ".archetype");
+            continue;
+        }
+
+        // LoadFileInternal overwrites the file-name key, so keep the old values
+        // to restore on a bad parse and to tell what actually changed
+        std::vector<std::pair<std::string, Archetype>> before;
+        for (const std::string& key : known->second) before.emplace_back(key, archetypes[key]);
+
+        std::unordered_set<std::string> loading;
+        Archetype fresh = LoadFileInternal(path, loading);
+        if (fresh.isEmpty()) {
+            Log::Warning("Archetype reload failed for " + path + " (keeping its last loaded version)");
+            for (const auto& [key, old] : before) archetypes[key] = old;
+            continue;
+        }
+        for (const auto& [key, old] : before) {
+            Archetype updated = fresh;
+            updated.source_path = old.source_path;
+            archetypes[key] = updated;
+            if (SameArchetype(old, updated)) continue;
+            auto id = ids.find(key);
+            if (id != ids.end()) changed.push_back(id->second);
+        }
+    }
+    return changed;
+}
+
 size_t ArchetypeManager::GetLoadedCount() const {
     return archetypes.size();
 }
\ No newline at end of file
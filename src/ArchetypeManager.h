@@ -6,15 +6,31 @@
 #include <map>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 // Manager for loading and accessing archetypes
 class ArchetypeManager {
 public:
     static ArchetypeManager& GetInstance();
 
-    // The public-facing entry point
+    // The public-facing entry point. Uses the compiled cache (ArchetypeCache)
+    // when the directory's files are unchanged, and refreshes it when it parses.
     void LoadArchetypesFromDirectory(const std::string& directoryPath);
     Archetype* GetArchetype(const std::string& name);
+    // Id for a loaded archetype name, or INVALID_ARCHETYPE (with a warning)
+    ArchetypeId FindArchetypeId(const std::string& name);
+    // Null for an unknown id
+    Archetype* GetArchetype(ArchetypeId id);
+    const std::string& GetArchetypeName(ArchetypeId id) const;
+    // The changed .archetype files (names within the directory) followed by the
+    // files of every archetype inheriting from them, parents before children
+    std::vector<std::string> ExpandReload(const std::vector<std::string>& fileNames) const;
+    // Re-parse these .archetype files (names within directoryPath) in the order
+    // given, which ExpandReload provides, updating map entries in place so ids
+    // and pointers stay valid. New files are loaded; deleted or unparsable ones
+    // keep their last good version. Returns the ids (of names already resolved
+    // with FindArchetypeId) whose values changed.
+    std::vector<ArchetypeId> ReloadFiles(const std::string& directoryPath, const std::vector<std::string>& fileNames);
     // Return the number of loaded archetypes
     size_t GetLoadedCount() const;
 
@@ -25,9 +41,25 @@ private:
     Archetype LoadFile(const std::string& filepath);
     // Loads an archetype into the internal map and returns true on success
     bool LoadFileToMap(const std::string& filepath);
+    // Map insert that refuses to replace an archetype from a different file.
+    // Every insert made while loading goes through here, parsed or cached.
+    bool StoreArchetype(const std::string& key, const Archetype& a);
+    // Note the files outside childPath's directory that parent's values came from
+    void RecordInheritedFrom(const std::string& childPath, const Archetype& parent);
     // Internal implementation used to track recursive loads and detect cycles
     Archetype LoadFileInternal(const std::string& filepath, std::unordered_set<std::string>& loading);
     
     std::unordered_map<std::string, Archetype> archetypes;
+    // Ids are handed out on first lookup; map nodes never move, so the pointers hold
+    std::vector<Archetype*> by_id;
+    std::vector<std::string> id_names;
+    std::unordered_map<std::string, ArchetypeId> ids;
     std::string current_directory; // Stores the directory
+    // While parsing a directory: the keys stored and the files from other
+    // directories that were inherited from (both go into its cache)
+    struct Recording {
+        std::vector<std::string> keys;
+        std::vector<std::string> inheritedFrom;
+    };
+    Recording* recording = nullptr;
 };
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include "ArchetypeWatcher.h"
+#include "ArchetypeManager.h"
+#include "Config.h"
+#include "EntityManager.h"
+#include "Log.h"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+    // Editors often save in several steps (truncate, write, rename); wait this
+    // long after the last change before reloading
+    constexpr float SETTLE_SECONDS = 0.15f;
+
+    struct FileStamp {
+        uintmax_t size = 0;
+        int64_t mtime = 0;
+        bool operator!=(const FileStamp& o) const { return size != o.size || mtime != o.mtime; }
+    };
+
+    struct WatchState {
+        bool active = false;
+        std::string dir;
+        std::set<std::string> pending; // changed file names, sorted so reloads are deterministic
+        float quiet = 0.0f;            // seconds since a change was last seen
+        // Files still to reload, descendants included, parents first; worked
+        // off filesPerFrame at a time
+        std::deque<std::string> queue;
+        int filesPerFrame = 4;
+        int entitiesPerFrame = 4096;   // archetype patches written per frame
+        size_t patched = 0;            // entities patched since the patch queue was last empty
+        // Polling fallback
+        float pollInterval = 0.5f;
+        float pollTimer = 0.0f;
+        std::unordered_map<std::string, FileStamp> stamps;
+#if defined(__linux__)
+        int fd = -1;
+#endif
+    };
+
+    WatchState g_watch;
+
+    bool IsArchetypeFile(const std::string& name) {
+        const std::string ext = ".archetype";
+        return name.size() > ext.size() && name.compare(name.size() - ext.size(), ext.size(), ext) == 0;
+    }
+
+    std::unordered_map<std::string, FileStamp> Scan(const std::string& dir) {
+        std::unordered_map<std::string, FileStamp> stamps;
+        std::error_code ec;
+        for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+            const std::string name = it->path().filename().string();
+            if (!IsArchetypeFile(name)) continue;
+            FileStamp st;
+            st.size = it->file_size(ec);
+            st.mtime = static_cast<int64_t>(it->last_write_time(ec).time_since_epoch().count());
+            if (!ec) stamps.emplace(name, st);
+        }
+        return stamps;
+    }
+
+    void MarkChanged(const std::string& name) {
+        g_watch.pending.insert(name);
+        g_watch.quiet = 0.0f;
+    }
+
+    // Compare a fresh listing with the last one; costs one directory scan per poll
+    void Poll() {
+        std::unordered_map<std::string, FileStamp> now = Scan(g_watch.dir);
+        for (const auto& [name, st] : now) {
+            auto old = g_watch.stamps.find(name);
+            if (old == g_watch.stamps.end() || old->second != st) MarkChanged(name);
+        }
+        for (const auto& [name, st] : g_watch.stamps) {
+            if (now.find(name) == now.end()) MarkChanged(name);
+        }
+        g_watch.stamps = std::move(now);
+    }
+
+#if defined(__linux__)
+    bool OpenInotify() {
+        int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0) return false;
+        if (inotify_add_watch(fd, g_watch.dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE) < 0) {
+            close(fd);
+            return false;
+        }
+        g_watch.fd = fd;
+        return true;
+    }
+
+    void ReadInotify() {
+        alignas(inotify_event) char buf[4096];
+        for (;;) {
+            const ssize_t n = read(g_watch.fd, buf, sizeof(buf));
+            if (n <= 0) break; // EAGAIN: nothing more queued
+            for (char* p = buf; p < buf + n;) {
+                const inotify_event* ev = reinterpret_cast<const inotify_event*>(p);
+                if (ev->mask & IN_Q_OVERFLOW) {
+                    // Events were dropped; treat every file as changed
+                    for (const auto& entry : Scan(g_watch.dir)) MarkChanged(entry.first);
+                } else if (ev->len > 0 && IsArchetypeFile(ev->name)) {
+                    MarkChanged(ev->name);
+                }
+                p += sizeof(inotify_event) + ev->len;
+            }
+        }
+    }
+#endif
+}
+
+void ArchetypeWatcher::Init(const std::string& directoryPath) {
+    Shutdown();
+    g_watch.dir = directoryPath;
+    g_watch.filesPerFrame = std::max(1, Config::GetInt("archetypes.reload_files_per_frame", 4));
+    g_watch.entitiesPerFrame = std::max(1, Config::GetInt("archetypes.reload_entities_per_frame", 4096));
+    g_watch.pollInterval = std::max(50, Config::GetInt("archetypes.reload_poll_ms", 500)) / 1000.0f;
+    g_watch.active = true;
+
+#if defined(__linux__)
+    if (OpenInotify()) {
+        Log::Info("Archetype hot reload: watching " + directoryPath + " (inotify)");
+        return;
+    }
+    Log::Warning("Archetype hot reload: inotify unavailable for " + directoryPath + ", polling instead");
+#endif
+    g_watch.stamps = Scan(directoryPath);
+    Log::Info("Archetype hot reload: polling " + directoryPath + " every " +
+              std::to_string(static_cast<int>(g_watch.pollInterval * 1000.0f)) + " ms");
+}
+
+void ArchetypeWatcher::Update(float dt) {
+    if (!g_watch.active) return;
+
+#if defined(__linux__)
+    if (g_watch.fd >= 0) {
+        ReadInotify();
+    } else
+#endif
+    {
+        g_watch.pollTimer -= dt;
+        if (g_watch.pollTimer <= 0.0f) {
+            g_watch.pollTimer = g_watch.pollInterval;
+            Poll();
+        }
+    }
+
+    g_watch.quiet += dt;
+    ArchetypeManager& archetypes = ArchetypeManager::GetInstance();
+    if (!g_watch.pending.empty() && g_watch.quiet >= SETTLE_SECONDS) {
+        // Plan again together with what is still queued, so a newly edited
+        // parent goes ahead of children queued earlier
+        std::vector<std::string> files(g_watch.queue.begin(), g_watch.queue.end());
+        files.insert(files.end(), g_watch.pending.begin(), g_watch.pending.end());
+        g_watch.pending.clear();
+        std::vector<std::string> planned = archetypes.ExpandReload(files);
+        g_watch.queue.assign(planned.begin(), planned.end());
+    }
+    EntityManager& entities = EntityManager::GetInstance();
+    if (!g_watch.queue.empty()) {
+        // A bounded batch per frame, descendants counted; the rest waits for the next frame
+        std::vector<std::string> batch;
+        while (!g_watch.queue.empty() && static_cast<int>(batch.size()) < g_watch.filesPerFrame) {
+            batch.push_back(std::move(g_watch.queue.front()));
+            g_watch.queue.pop_front();
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<ArchetypeId> changed = archetypes.ReloadFiles(g_watch.dir, batch);
+        size_t queued = entities.RefreshArchetypes(changed);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        Log::Info("Archetype hot reload: " + std::to_string(batch.size()) + " file(s) (" + std::to_string(g_watch.queue.size()) +
+                  " queued), " + std::to_string(changed.size()) + " archetype(s) changed, " + std::to_string(queued) +
+                  " entities to patch, " + std::to_string(ms) + " ms");
+    }
+
+    // Entity patches have their own cap, so a widely used archetype is applied over several frames
+    if (entities.GetQueuedPatches() == 0) return;
+    g_watch.patched += entities.PatchSpawned(static_cast<size_t>(g_watch.entitiesPerFrame));
+    if (entities.GetQueuedPatches() == 0) {
+        Log::Info("Archetype hot reload: " + std::to_string(g_watch.patched) + " entities patched");
+        g_watch.patched = 0;
+    }
+}
+
+void ArchetypeWatcher::Shutdown() {
+#if defined(__linux__)
+    if (g_watch.fd >= 0) close(g_watch.fd);
+#endif
+    g_watch = WatchState{};
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <string>
+
+// Archetype hot reload (archetypes.hot_reload). Watches the directory the game
+// loaded its archetypes from (inotify on Linux, mtime polling elsewhere or if
+// inotify is unavailable), and once a burst of edits settles reloads the
+// changed files and their descendants, then patches the entities spawned from
+// them in place. Work per frame is capped by archetypes.reload_files_per_frame,
+// descendants included, and archetypes.reload_entities_per_frame; the rest
+// carries over to the next frames.
+namespace ArchetypeWatcher {
+    void Init(const std::string& directoryPath);
+    // Call once per frame before entities update
+    void Update(float dt);
+    void Shutdown();
+}
@@ -0,0 +1,327 @@
+#include "Benchmarks.h"
+#include "ArchetypeManager.h"
+#include "BroadPhase.h"
+#include "Chunk.h"
+#include "Config.h"
+#include "EntityManager.h"
+#include "GenerationStages.h"
+#include "HeightmapGenerator.h"
+#include "Log.h"
+#include "PerlinNoise.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <initializer_list>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::high_resolution_clock;
+
+    double SecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Keeps the optimizer from discarding benchmark output
+    volatile unsigned g_sink = 0;
+
+    // The original generator: one scalar height per column, one byte per block
+    void GenerateChunkScalar(const HeightmapGenerator& gen, const ChunkCoord& coord, BlockId* out, int size) {
+        for (int i = 0; i < size * size * size; ++i) out[i] = 0;
+        for (int lx = 0; lx < size; ++lx) {
+            for (int lz = 0; lz < size; ++lz) {
+                int ih = static_cast<int>(std::floor(gen.SampleHeight(coord.x * size + lx, coord.z * size + lz)));
+                for (int y = 0; y < size; ++y) {
+                    if (coord.y * size + y <= ih) out[lx + lz * size + y * size * size] = 1;
+                }
+            }
+        }
+    }
+
+    // The collision broad phase before it was pluggable: AABB centers hashed into
+    // 1-unit XZ cells, each cell tested against its 3x3 neighbourhood. Kept as the
+    // baseline for the broad phase benchmark (it misses tall, wide and stacked pairs).
+    void FindPairsXZHash(const std::vector<BoundingBox>& boxes, std::vector<BroadPhasePair>& pairs) {
+        auto key = [](int x, int z) { return (static_cast<int64_t>(x) << 32) ^ static_cast<uint32_t>(z); };
+        std::unordered_map<int64_t, std::vector<uint32_t>> buckets;
+        buckets.reserve(boxes.size() * 2);
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            int cx = static_cast<int>(std::floor((boxes[i].min.x + boxes[i].max.x) * 0.5f));
+            int cz = static_cast<int>(std::floor((boxes[i].min.z + boxes[i].max.z) * 0.5f));
+            buckets[key(cx, cz)].push_back(static_cast<uint32_t>(i));
+        }
+        pairs.clear();
+        for (const auto& [k, a] : buckets) {
+            int cx = static_cast<int>(k >> 32);
+            int cz = static_cast<int>(static_cast<uint32_t>(k & 0xffffffff));
+            for (int dx = -1; dx <= 1; ++dx)
+                for (int dz = -1; dz <= 1; ++dz) {
+                    auto it = buckets.find(key(cx + dx, cz + dz));
+                    if (it == buckets.end()) continue;
+                    for (uint32_t i : a)
+                        for (uint32_t j : it->second)
+                            if (i < j) pairs.push_back(BroadPhasePair{ i, j });
+                }
+        }
+    }
+}
+
+void Benchmarks::RunFromConfig() {
+    if (!Config::GetBool("debug.benchmarks", false)) return;
+    Log::Info("Benchmarks: running (debug.benchmarks = true)");
+    WorldGen();
+    Noise();
+    Spawn();
+    BroadPhase();
+}
+
+void Benchmarks::WorldGen() {
+    const int S = Chunk::SIZE;
+    const int radius = 16; // 33x33 chunk columns per pass
+    HeightmapGenerator gen;
+    std::vector<BlockId> blocks(S * S * S);
+    std::vector<BlockId> reference(S * S * S);
+
+    enum class Mode { Scalar, Batch, BatchCached };
+    auto run = [&](Mode mode, int layers) {
+        int chunks = 0;
+        gen.GetColumnCache().Clear();
+        auto start = Clock::now();
+        for (int cx = -radius; cx <= radius; ++cx)
+            for (int cz = -radius; cz <= radius; ++cz)
+                for (int cy = -layers / 2; cy < layers - layers / 2; ++cy) {
+                    ChunkCoord c{ cx, cy, cz };
+                    if (mode == Mode::Scalar) {
+                        GenerateChunkScalar(gen, c, blocks.data(), S);
+                    } else {
+                        // Without the cache every chunk rebuilds its column
+                        if (mode == Mode::Batch) gen.GetColumnCache().Clear();
+                        gen.GenerateChunk(c, blocks.data(), S);
+                    }
+                    g_sink = g_sink + blocks[(cx & 15) + (cz & 15) * S];
+                    ++chunks;
+                }
+        gen.GetColumnCache().Clear();
+        return chunks / SecondsSince(start);
+    };
+
+    for (int layers : { 3, 9 }) {
+        double scalarRate = run(Mode::Scalar, layers);
+        double batchRate = run(Mode::Batch, layers);
+        double cachedRate = run(Mode::BatchCached, layers);
+        char line[256];
+        std::snprintf(line, sizeof(line),
+                      "Benchmarks: worldgen %d-chunk stacks: scalar %.0f, batch %.0f (%.2fx), batch+column cache %.0f chunks/s (%.2fx)",
+                      layers, scalarRate, batchRate, scalarRate > 0 ? batchRate / scalarRate : 0.0,
+                      cachedRate, scalarRate > 0 ? cachedRate / scalarRate : 0.0);
+        Log::Info(line);
+    }
+
+    // Staged pipeline over 3-chunk stacks: terrain + surface only (comparable to
+    // batch+column cache above), then with every optional stage
+    for (bool full : { false, true }) {
+        GenerationStages::Settings settings;
+        settings.caves = settings.ores = settings.boulders = full;
+        auto pipeline = GenerationStages::CreateWorldPipeline(settings);
+        int chunks = 0;
+        auto start = Clock::now();
+        for (int cx = -radius; cx <= radius; ++cx)
+            for (int cz = -radius; cz <= radius; ++cz)
+                for (int cy = -1; cy <= 1; ++cy) {
+                    pipeline->GenerateChunk(ChunkCoord{ cx, cy, cz }, blocks.data(), S);
+                    g_sink = g_sink + blocks[(cx & 15) + (cz & 15) * S];
+                    ++chunks;
+                }
+        double rate = chunks / SecondsSince(start);
+
+        char line[256];
+        int len = std::snprintf(line, sizeof(line), "Benchmarks: worldgen pipeline %s: %.0f chunks/s, us/chunk",
+                                full ? "all stages" : "terrain+surface", rate);
+        for (const auto& st : pipeline->GetStageStats()) {
+            if (len < 0 || len >= static_cast<int>(sizeof(line))) break;
+            len += std::snprintf(line + len, sizeof(line) - len, " %s=%.2f", st.name, st.avgMicros);
+        }
+        Log::Info(line);
+    }
+
+    // The polynomial sine may move a column across an integer height boundary;
+    // count how often that happens
+    long mismatched = 0, total = 0;
+    for (int cx = -radius; cx <= radius; cx += 4)
+        for (int cz = -radius; cz <= radius; cz += 4) {
+            ChunkCoord c{ cx, 0, cz };
+            gen.GenerateChunk(c, blocks.data(), S);
+            GenerateChunkScalar(gen, c, reference.data(), S);
+            for (size_t i = 0; i < blocks.size(); ++i) mismatched += blocks[i] != reference[i];
+            total += static_cast<long>(blocks.size());
+        }
+
+    char line[128];
+    std::snprintf(line, sizeof(line), "Benchmarks: worldgen batch vs scalar: %ld/%ld blocks differ", mismatched, total);
+    Log::Info(line);
+}
+
+void Benchmarks::Noise() {
+    const int S = Chunk::SIZE;
+    const int chunks = 512;
+    const float step = 1.0f / 32.0f; // noise units per block
+    const float warp = 0.75f;
+    PerlinNoise noise(1234);
+    std::vector<float> grid(S * S * S);
+
+    // Each case fills one chunk's worth of samples (a 16x16 column grid, or the
+    // full 16^3 volume for 3D) per iteration, batch first, then scalar
+    auto report = [&](const char* name, int samplesPerChunk, auto batch, auto scalar) {
+        auto start = Clock::now();
+        for (int c = 0; c < chunks; ++c) batch(c);
+        double batchRate = chunks * samplesPerChunk / SecondsSince(start);
+
+        double sum = 0.0;
+        start = Clock::now();
+        for (int c = 0; c < chunks; ++c)
+            for (int i = 0; i < samplesPerChunk; ++i) sum += scalar(c, i);
+        double scalarRate = chunks * samplesPerChunk / SecondsSince(start);
+        g_sink = g_sink + static_cast<unsigned>(sum);
+
+        double maxDiff = 0.0;
+        for (int c = 0; c < chunks; c += 8) {
+            batch(c);
+            for (int i = 0; i < samplesPerChunk; ++i) maxDiff = std::max(maxDiff, std::fabs(grid[i] - scalar(c, i)));
+        }
+
+        char line[256];
+        std::snprintf(line, sizeof(line), "Benchmarks: noise %s batch %.1f M samples/s, scalar %.1f M samples/s (%.2fx), max diff %.2g",
+                      name, batchRate / 1e6, scalarRate / 1e6, scalarRate > 0 ? batchRate / scalarRate : 0.0, maxDiff);
+        Log::Info(line);
+    };
+
+    // Chunk c sits at (c * S, c * S) in blocks
+    auto origin = [&](int c) { return static_cast<float>(c * S) * step; };
+
+    report("2d", S * S,
+           [&](int c) { noise.noiseGrid(origin(c), origin(c), step, S, S, grid.data()); },
+           [&](int c, int i) { return noise.noise(origin(c) + (i % S) * step, origin(c) + (i / S) * step); });
+    report("3d", S * S * S,
+           [&](int c) { noise.noiseGrid3(origin(c), 0.0f, origin(c), step, S, S, S, grid.data()); },
+           [&](int c, int i) {
+               return noise.noise3(origin(c) + (i % S) * step, (i / (S * S)) * step, origin(c) + ((i / S) % S) * step);
+           });
+    report("warped", S * S,
+           [&](int c) { noise.warpedNoiseGrid(origin(c), origin(c), step, S, S, warp, grid.data()); },
+           [&](int c, int i) { return noise.warpedNoise(origin(c) + (i % S) * step, origin(c) + (i / S) * step, warp); });
+}
+
+void Benchmarks::Spawn() {
+    const size_t count = 10000;
+    const int rounds = 5;
+    const ArchetypeId id = ArchetypeManager::GetInstance().FindArchetypeId("cube_red");
+    if (id == INVALID_ARCHETYPE) {
+        Log::Info("Benchmarks: spawn skipped (no cube_red archetype loaded)");
+        return;
+    }
+    EntityManager& em = EntityManager::GetInstance();
+
+    // A conveyor's worth of items in a line
+    std::vector<Vector3> positions(count);
+    for (size_t i = 0; i < count; ++i) positions[i] = { static_cast<float>(i % 100), 0.5f, static_cast<float>(i / 100) };
+    std::vector<EntityHandle> handles(count);
+
+    // Best of a few rounds; each starts from an empty world (no blocks allocated)
+    double batchBest = 1e9;
+    double singleBest = 1e9;
+    size_t spawned = 0;
+    for (int r = 0; r < rounds; ++r) {
+        em.Init();
+        auto start = Clock::now();
+        spawned = em.SpawnBatch(id, count, positions, handles);
+        batchBest = std::min(batchBest, SecondsSince(start));
+
+        em.Init();
+        start = Clock::now();
+        for (size_t i = 0; i < count; ++i) em.CreateEntityFromArchetype("cube_red", positions[i]);
+        singleBest = std::min(singleBest, SecondsSince(start));
+    }
+    em.Init();
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "Benchmarks: spawn %zu entities: batch %.3f ms, one by one %.3f ms (%.1fx)",
+                  spawned, batchBest * 1e3, singleBest * 1e3, batchBest > 0 ? singleBest / batchBest : 0.0);
+    Log::Info(line);
+}
+
+void Benchmarks::BroadPhase() {
+    const int frames = 10;
+    const float cellSize = Config::GetFloat("collision.cell_size", 2.0f);
+    const int threads = ThreadPool::GetInstance().GetThreadCount() + 1; // workers and the caller
+    const std::string pooled = "grid x" + std::to_string(threads);
+    const char* methods[] = { "xz hash", "grid", "sweep", pooled.c_str() };
+    const size_t methodCount = 4;
+    const size_t chunkCount = 64;
+
+    for (size_t count : { size_t{ 1000 }, size_t{ 10000 }, size_t{ 100000 } }) {
+        // Boxes 0.5-1.5 units wide on a 4-unit high slab, about one per 4 square
+        // units whatever the count, drifting slowly so frames stay coherent
+        std::mt19937 rng(42);
+        const float side = std::sqrt(static_cast<float>(count) * 4.0f);
+        std::uniform_real_distribution<float> pos(0.0f, side), height(0.0f, 4.0f), size(0.5f, 1.5f), vel(-0.05f, 0.05f);
+        std::vector<Vector3> centers(count), halves(count), velocities(count);
+        for (size_t i = 0; i < count; ++i) {
+            centers[i] = { pos(rng), height(rng), pos(rng) };
+            halves[i] = { size(rng) * 0.5f, size(rng) * 0.5f, size(rng) * 0.5f };
+            velocities[i] = { vel(rng), vel(rng) * 0.2f, vel(rng) };
+        }
+
+        UniformGridBroadPhase grid(cellSize);
+        SweepAndPruneBroadPhase sweep;
+        std::vector<BoundingBox> boxes(count);
+        std::vector<BroadPhasePair> pairs;
+        std::vector<std::vector<BroadPhasePair>> chunkPairs(chunkCount);
+        double seconds[methodCount] = {};
+        size_t candidates[methodCount] = {};
+        size_t overlapping[methodCount] = {};
+        for (int f = 0; f < frames; ++f) {
+            for (size_t i = 0; i < count; ++i) {
+                centers[i].x += velocities[i].x;
+                centers[i].y += velocities[i].y;
+                centers[i].z += velocities[i].z;
+                const Vector3 c = centers[i], h = halves[i];
+                boxes[i] = BoundingBox{ { c.x - h.x, c.y - h.y, c.z - h.z }, { c.x + h.x, c.y + h.y, c.z + h.z } };
+            }
+            for (size_t m = 0; m < methodCount; ++m) {
+                auto start = Clock::now();
+                if (m == 0) FindPairsXZHash(boxes, pairs);
+                else if (m == 1) grid.FindPairs(boxes, pairs);
+                else if (m == 2) sweep.FindPairs(boxes, pairs);
+                else {
+                    // Pair generation split over the pool, as CollisionSystem does it
+                    const size_t items = grid.Prepare(boxes);
+                    ThreadPool::GetInstance().ParallelFor(chunkCount, [&](size_t c) {
+                        chunkPairs[c].clear();
+                        grid.CollectPairs(items * c / chunkCount, items * (c + 1) / chunkCount, chunkPairs[c]);
+                    });
+                    pairs.clear();
+                    for (const auto& chunk : chunkPairs) pairs.insert(pairs.end(), chunk.begin(), chunk.end());
+                }
+                seconds[m] += SecondsSince(start);
+                if (f != frames - 1) continue;
+                candidates[m] = pairs.size();
+                for (const BroadPhasePair& p : pairs) overlapping[m] += CheckCollisionBoxes(boxes[p.a], boxes[p.b]);
+            }
+        }
+
+        // The first frame (full sort, table growth) is included in the average
+        char line[384];
+        int len = std::snprintf(line, sizeof(line), "Benchmarks: broad phase %zu boxes, ms/frame (candidates, overlapping):", count);
+        for (size_t m = 0; m < methodCount; ++m) {
+            if (len < 0 || len >= static_cast<int>(sizeof(line))) break;
+            len += std::snprintf(line + len, sizeof(line) - len, " %s %.3f (%zu, %zu)", methods[m],
+                                 seconds[m] * 1e3 / frames, candidates[m], overlapping[m]);
+        }
+        Log::Info(line);
+        if (overlapping[1] != overlapping[2] || overlapping[1] != overlapping[3])
+            Log::Warning("Benchmarks: broad phases disagree on overlapping pairs");
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+// Startup micro-benchmarks for hot engine paths. Enabled with debug.benchmarks
+// in config.ini; results go to the log.
+namespace Benchmarks {
+    // Run every benchmark (only when debug.benchmarks is true)
+    void RunFromConfig();
+
+    // Terrain generation throughput: batch heightmap vs the per-column scalar path
+    void WorldGen();
+
+    // PerlinNoise batch grids vs scalar calls: throughput and largest difference
+    void Noise();
+
+    // 10k entities of one archetype: SpawnBatch vs CreateEntityFromArchetype per
+    // entity. Resets the EntityManager before and after, so it runs before the game
+    // spawns anything (and after archetypes are loaded; skipped without cube_red).
+    void Spawn();
+
+    // Collision broad phase at 1k, 10k and 100k moving boxes: the uniform grid and
+    // sort-and-sweep against the old XZ center hash, plus the grid split over the
+    // thread pool. Logs ms/frame and pair counts.
+    void BroadPhase();
+}
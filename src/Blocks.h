@@ -0,0 +1,13 @@
+#pragma once
+
+// Small integer type for blocks; 0 == air
+using BlockId = unsigned char;
+
+// Block ids the generators place (surfaces in GreedyMesher::GetBlockSurface)
+namespace Blocks {
+    constexpr BlockId AIR = 0;
+    constexpr BlockId DIRT = 1;
+    constexpr BlockId STONE = 2;
+    constexpr BlockId ORE = 3;
+    constexpr BlockId WATER = 4;
+}
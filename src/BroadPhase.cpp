@@ -0,0 +1,235 @@
+#include "BroadPhase.h"
+#include "Log.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+    // Boxes touching more cells than this go on the test-against-everything list
+    constexpr int64_t MAX_CELLS_PER_BOX = 64;
+
+    // Never a packed cell: those use the low 63 bits
+    constexpr uint64_t EMPTY_KEY = ~uint64_t{ 0 };
+
+    // 21 bits per axis. Coordinates a multiple of 2^21 cells apart share a key,
+    // which only costs extra candidates (keys, not coordinates, are compared).
+    uint64_t PackCell(int x, int y, int z) {
+        const uint64_t m = (1u << 21) - 1;
+        return (static_cast<uint64_t>(x) & m) << 42 | (static_cast<uint64_t>(y) & m) << 21 | (static_cast<uint64_t>(z) & m);
+    }
+
+    uint64_t MixKey(uint64_t k) {
+        k ^= k >> 33;
+        k *= 0xFF51AFD7ED558CCDull;
+        k ^= k >> 33;
+        return k;
+    }
+
+    bool Overlaps(const BoundingBox& a, const BoundingBox& b) {
+        return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y &&
+               a.min.z <= b.max.z && b.min.z <= a.max.z;
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+UniformGridBroadPhase::UniformGridBroadPhase(float cellSize)
+    : cellSize(cellSize > 0.0f ? cellSize : 1.0f), invCellSize(1.0f / this->cellSize) {}
+
+void UniformGridBroadPhase::Rehash(size_t slotCount) {
+    slots.assign(slotCount, Slot{ EMPTY_KEY, 0 });
+    const size_t mask = slotCount - 1;
+    for (size_t c = 0; c < cellCoords.size() / 3; ++c) {
+        const uint64_t key = PackCell(cellCoords[c * 3], cellCoords[c * 3 + 1], cellCoords[c * 3 + 2]);
+        size_t h = MixKey(key) & mask;
+        while (slots[h].key != EMPTY_KEY) h = (h + 1) & mask;
+        slots[h] = Slot{ key, static_cast<uint32_t>(c) };
+    }
+}
+
+void UniformGridBroadPhase::ClearCells() {
+    for (Slot& slot : slots) slot.key = EMPTY_KEY;
+    cellCoords.clear();
+}
+
+uint32_t UniformGridBroadPhase::CellIndex(int x, int y, int z) {
+    const uint32_t cells = static_cast<uint32_t>(cellCoords.size() / 3);
+    if ((cells + 1) * 2 > slots.size()) Rehash(std::max<size_t>(64, slots.size() * 2)); // keep load under half
+
+    const uint64_t key = PackCell(x, y, z);
+    const size_t mask = slots.size() - 1;
+    size_t h = MixKey(key) & mask;
+    for (;;) {
+        Slot& slot = slots[h];
+        if (slot.key == key) return slot.cell;
+        if (slot.key == EMPTY_KEY) {
+            slot = Slot{ key, cells };
+            cellCoords.push_back(x);
+            cellCoords.push_back(y);
+            cellCoords.push_back(z);
+            return cells;
+        }
+        h = (h + 1) & mask;
+    }
+}
+
+size_t UniformGridBroadPhase::Prepare(std::span<const BoundingBox> boxes) {
+    prepared = boxes;
+    const size_t n = boxes.size();
+    // Last call's boxes can only be reused if these are the same boxes in the same order
+    bool coherent = n == ranges.size();
+    std::swap(ranges, prevRanges);
+    std::swap(boxFirst, prevBoxFirst);
+    std::swap(entryCells, prevEntryCells);
+    ranges.resize(n);
+    oversized.clear();
+
+    // Cell range of every box; total is the number of (cell, box) entries
+    size_t total = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const BoundingBox& b = boxes[i];
+        CellRange& r = ranges[i];
+        r.x0 = static_cast<int>(std::floor(b.min.x * invCellSize));
+        r.y0 = static_cast<int>(std::floor(b.min.y * invCellSize));
+        r.z0 = static_cast<int>(std::floor(b.min.z * invCellSize));
+        r.x1 = static_cast<int>(std::floor(b.max.x * invCellSize));
+        r.y1 = static_cast<int>(std::floor(b.max.y * invCellSize));
+        r.z1 = static_cast<int>(std::floor(b.max.z * invCellSize));
+        const int64_t cells = int64_t{ r.x1 - r.x0 + 1 } * (r.y1 - r.y0 + 1) * (r.z1 - r.z0 + 1);
+        if (cells > MAX_CELLS_PER_BOX || cells <= 0) {
+            oversized.push_back(static_cast<uint32_t>(i));
+            r.x1 = r.x0 - 1; // marks the box as oversized
+            continue;
+        }
+        total += static_cast<size_t>(cells);
+    }
+
+    // Cells left behind by moving boxes stay in the table; start over once
+    // they clearly outnumber the live ones
+    if (cellCoords.size() / 3 > total * 4 + 1024) {
+        ClearCells();
+        coherent = false;
+    }
+
+    entryCells.clear();
+    entryCells.reserve(total);
+    boxFirst.resize(n + 1);
+    for (size_t i = 0; i < n; ++i) {
+        boxFirst[i] = static_cast<uint32_t>(entryCells.size());
+        const CellRange& r = ranges[i];
+        if (coherent && r == prevRanges[i]) {
+            entryCells.insert(entryCells.end(), prevEntryCells.begin() + prevBoxFirst[i],
+                              prevEntryCells.begin() + prevBoxFirst[i + 1]);
+            continue;
+        }
+        for (int x = r.x0; x <= r.x1; ++x)
+            for (int y = r.y0; y <= r.y1; ++y)
+                for (int z = r.z0; z <= r.z1; ++z) entryCells.push_back(CellIndex(x, y, z));
+    }
+    boxFirst[n] = static_cast<uint32_t>(entryCells.size());
+
+    // Counting sort of boxes by cell; each cell's list comes out in box order
+    const size_t cells = cellCoords.size() / 3;
+    cellStart.assign(cells + 1, 0);
+    for (uint32_t c : entryCells) ++cellStart[c + 1];
+    for (size_t c = 0; c < cells; ++c) cellStart[c + 1] += cellStart[c];
+    items.resize(entryCells.size());
+    for (size_t i = 0; i < n; ++i)
+        for (uint32_t e = boxFirst[i]; e < boxFirst[i + 1]; ++e) items[cellStart[entryCells[e]]++] = static_cast<uint32_t>(i);
+    for (size_t c = cells; c > 0; --c) cellStart[c] = cellStart[c - 1];
+    cellStart[0] = 0;
+    return cells + oversized.size();
+}
+
+void UniformGridBroadPhase::CollectPairs(size_t begin, size_t end, std::vector<BroadPhasePair>& pairs) const {
+    const size_t cells = cellStart.size() - 1;
+    for (size_t c = begin; c < std::min(end, cells); ++c) {
+        const uint32_t first = cellStart[c];
+        const uint32_t last = cellStart[c + 1];
+        if (last - first < 2) continue;
+        const uint64_t key = PackCell(cellCoords[c * 3], cellCoords[c * 3 + 1], cellCoords[c * 3 + 2]);
+        for (uint32_t p = first; p < last; ++p) {
+            const uint32_t a = items[p];
+            const CellRange& ra = ranges[a];
+            for (uint32_t q = p + 1; q < last; ++q) {
+                const uint32_t b = items[q];
+                const CellRange& rb = ranges[b];
+                // Report the pair only from the cell where both ranges start to overlap
+                if (PackCell(std::max(ra.x0, rb.x0), std::max(ra.y0, rb.y0), std::max(ra.z0, rb.z0)) != key) continue;
+                pairs.push_back(BroadPhasePair{ a, b });
+            }
+        }
+    }
+
+    for (size_t item = std::max(begin, cells); item < end; ++item) {
+        const uint32_t o = oversized[item - cells];
+        for (size_t i = 0; i < prepared.size(); ++i) {
+            const uint32_t other = static_cast<uint32_t>(i);
+            if (other == o) continue;
+            // Two oversized boxes meet once, from the lower index
+            if (ranges[other].x1 < ranges[other].x0 && other < o) continue;
+            if (!Overlaps(prepared[o], prepared[other])) continue;
+            pairs.push_back(BroadPhasePair{ std::min(o, other), std::max(o, other) });
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+size_t SweepAndPruneBroadPhase::Prepare(std::span<const BoundingBox> boxes) {
+    const size_t n = boxes.size();
+    auto byMinX = [&boxes](uint32_t a, uint32_t b) { return boxes[a].min.x < boxes[b].min.x; };
+
+    if (order.size() != n) {
+        order.resize(n);
+        std::iota(order.begin(), order.end(), 0u);
+        std::sort(order.begin(), order.end(), byMinX);
+    } else {
+        // Repair last frame's order; give up on it if that takes too many moves
+        const size_t limit = 8 * n + 64;
+        size_t moves = 0;
+        bool repaired = true;
+        for (size_t i = 1; i < n && repaired; ++i) {
+            const uint32_t v = order[i];
+            const float key = boxes[v].min.x;
+            size_t j = i;
+            while (j > 0 && boxes[order[j - 1]].min.x > key) {
+                order[j] = order[j - 1];
+                --j;
+                if (++moves > limit) {
+                    repaired = false;
+                    break;
+                }
+            }
+            order[j] = v;
+        }
+        if (!repaired) std::sort(order.begin(), order.end(), byMinX);
+    }
+
+    // Sweep over a sorted copy so the inner loop reads memory in order
+    sorted.resize(n);
+    for (size_t k = 0; k < n; ++k) sorted[k] = boxes[order[k]];
+    return n;
+}
+
+void SweepAndPruneBroadPhase::CollectPairs(size_t begin, size_t end, std::vector<BroadPhasePair>& pairs) const {
+    const size_t n = sorted.size();
+    for (size_t k = begin; k < end; ++k) {
+        const BoundingBox& a = sorted[k];
+        for (size_t m = k + 1; m < n && sorted[m].min.x <= a.max.x; ++m) {
+            const BoundingBox& b = sorted[m];
+            if (a.max.y < b.min.y || b.max.y < a.min.y || a.max.z < b.min.z || b.max.z < a.min.z) continue;
+            const uint32_t ia = order[k];
+            const uint32_t ib = order[m];
+            pairs.push_back(BroadPhasePair{ std::min(ia, ib), std::max(ia, ib) });
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+std::unique_ptr<BroadPhase> CreateBroadPhase(const std::string& name, float cellSize) {
+    if (name == "sweep") return std::make_unique<SweepAndPruneBroadPhase>();
+    if (name != "grid") Log::Warning("Unknown collision broad phase '" + name + "', using grid");
+    return std::make_unique<UniformGridBroadPhase>(cellSize);
+}
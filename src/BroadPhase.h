@@ -0,0 +1,104 @@
+#pragma once
+#include "include/raylib.h"
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+// Candidate pair of boxes, as indices into the span given to FindPairs (a < b)
+struct BroadPhasePair {
+    uint32_t a;
+    uint32_t b;
+};
+
+// Collision broad phase: narrows all box pairs down to the ones worth an exact
+// test. Implementations keep their working memory between calls so a steady
+// frame doesn't allocate, and may use last frame's results when the boxes come
+// in the same order as before (CollisionSystem gathers them in query order,
+// which only changes when entities are created, destroyed or change components).
+class BroadPhase {
+public:
+    virtual ~BroadPhase() = default;
+    virtual const char* Name() const = 0;
+
+    // Build this call's structure over `boxes`, which must stay alive and
+    // unchanged until the last CollectPairs. Returns the number of work items
+    // (grid cells, sweep positions) pair generation is split into.
+    virtual size_t Prepare(std::span<const BoundingBox> boxes) = 0;
+    // Append the pairs found by work items [begin, end). Every pair whose boxes
+    // may overlap comes from exactly one item, and pairs that overlap are always
+    // included. Safe to call from several threads at once.
+    virtual void CollectPairs(size_t begin, size_t end, std::vector<BroadPhasePair>& pairs) const = 0;
+
+    // Replace `pairs` with every candidate pair, all on the calling thread
+    void FindPairs(std::span<const BoundingBox> boxes, std::vector<BroadPhasePair>& pairs) {
+        const size_t items = Prepare(boxes);
+        pairs.clear();
+        CollectPairs(0, items, pairs);
+    }
+};
+
+// 3D uniform grid. Each box goes into every cell its extent touches, so large
+// boxes and stacked (same XZ) entities are handled; a pair sharing several
+// cells is only reported from the cell holding the corner where the two boxes'
+// overlap begins. Boxes spanning too many cells are tested against everything.
+// Cells persist between calls, and a box whose cell range is unchanged reuses
+// last call's cells without touching the hash table.
+class UniformGridBroadPhase : public BroadPhase {
+public:
+    explicit UniformGridBroadPhase(float cellSize = 2.0f);
+    const char* Name() const override { return "grid"; }
+    // One work item per cell, then one per oversized box
+    size_t Prepare(std::span<const BoundingBox> boxes) override;
+    void CollectPairs(size_t begin, size_t end, std::vector<BroadPhasePair>& pairs) const override;
+
+private:
+    struct CellRange {
+        int x0, y0, z0, x1, y1, z1;
+        bool operator==(const CellRange&) const = default;
+    };
+    struct Slot {
+        uint64_t key;
+        uint32_t cell;
+    };
+
+    // Dense index of a cell, added on first use
+    uint32_t CellIndex(int x, int y, int z);
+    void Rehash(size_t slotCount);
+    void ClearCells();
+
+    float cellSize;
+    float invCellSize;
+    std::span<const BoundingBox> prepared; // boxes from the last Prepare
+    std::vector<Slot> slots;            // open-addressed cell table
+    std::vector<int> cellCoords;        // 3 ints per dense cell
+
+    std::vector<CellRange> ranges;      // per box, this call and the last
+    std::vector<CellRange> prevRanges;
+    std::vector<uint32_t> boxFirst;     // per box (+1): first entry in entryCells
+    std::vector<uint32_t> prevBoxFirst;
+    std::vector<uint32_t> entryCells;   // cells touched by each box, in box order
+    std::vector<uint32_t> prevEntryCells;
+    std::vector<uint32_t> cellStart;    // per dense cell (+1): start in items
+    std::vector<uint32_t> items;        // boxes grouped by cell
+    std::vector<uint32_t> oversized;    // boxes tested against every other box
+};
+
+// Sort and sweep on X. The sorted order is kept between calls and repaired
+// with an insertion sort, which is close to linear when entities move a little
+// each frame; if the order changed too much it falls back to a full sort.
+class SweepAndPruneBroadPhase : public BroadPhase {
+public:
+    const char* Name() const override { return "sweep"; }
+    // One work item per box, in sorted order
+    size_t Prepare(std::span<const BoundingBox> boxes) override;
+    void CollectPairs(size_t begin, size_t end, std::vector<BroadPhasePair>& pairs) const override;
+
+private:
+    std::vector<uint32_t> order;   // box indices by min.x
+    std::vector<BoundingBox> sorted;
+};
+
+// "grid" or "sweep" (collision.broad_phase); unknown names fall back to the grid
+std::unique_ptr<BroadPhase> CreateBroadPhase(const std::string& name, float cellSize);
@@ -14,11 +14,23 @@ Chunk::Chunk() : blocks(SIZE * SIZE * SIZE, 0) {
 }
 
 Chunk::~Chunk() {
+    ReleaseModel();
+}
+
+void Chunk::ReleaseModel() {
     if (hasModel) {
         UnloadModel(model);
         hasModel = false;
+        model = {};
     }
     quads.clear();
+    quads.shrink_to_fit();
+    meshBytes = 0;
+    meshDirty = true;
+}
+
+size_t Chunk::GetCpuBytes() const {
+    return blocks.capacity() * sizeof(BlockId) + quads.capacity() * sizeof(Quad);
 }
 
 void Chunk::Init(const ChunkCoord& c) {
@@ -26,29 +38,46 @@ void Chunk::Init(const ChunkCoord& c) {
     path = ChunkPath(); // Will be set via InitWithPath if needed
     std::fill(blocks.begin(), blocks.end(), 0);
     quads.clear();
+    dirty = false;
+    meshDirty = true;
 }
 
 void Chunk::InitWithPath(const ChunkPath& p) {
     path = p;
-    coord = {0, 0, 0};
     std::fill(blocks.begin(), blocks.end(), 0);
     quads.clear();
+    dirty = false;
+    meshDirty = true;
 
-    const auto& steps = path.GetPath();
-    if (steps.empty()) {
-        return;
-    }
+    coord = CoordForPath(path);
+}
+
+ChunkCoord Chunk::CoordForPath(const ChunkPath& p) {
+    ChunkCoord c{0, 0, 0};
 
     // Derive coordinates from the path: each step encodes x,y,z offsets
     // x: -4 to 3, y: -4 to 3, z: -2 to 1; accumulate in base-8 for unique positions
-    for (uint8_t encoded : steps) {
+    for (int level = 0; level < p.GetDepth(); ++level) {
         int x, y, z;
-        ChunkPath::DecodeTriple(encoded, x, y, z);
+        ChunkPath::DecodeTriple(p.GetStep(level), x, y, z);
 
-        coord.x = coord.x * 8 + x;
-        coord.y = coord.y * 8 + y;
-        coord.z = coord.z * 8 + z;
+        c.x = c.x * 8 + x;
+        c.y = c.y * 8 + y;
+        c.z = c.z * 8 + z;
     }
+    return c;
+}
+
+void Chunk::SetPath(const ChunkPath& p) {
+    path = p;
+}
+
+const ChunkPath& Chunk::GetPath() const {
+    return path;
+}
+
+const ChunkCoord& Chunk::GetCoord() const {
+    return coord;
 }
 
 std::string Chunk::GetIdentifier() const {
@@ -68,46 +97,85 @@ BlockId Chunk::Get(int x, int y, int z) const {
 void Chunk::Set(int x, int y, int z, BlockId id) {
     if (x < 0 || x >= SIZE || y < 0 || y >= SIZE || z < 0 || z >= SIZE) return;
     int idx = x + z * SIZE + y * SIZE * SIZE;
+    if (blocks[idx] == id) return;
     blocks[idx] = id;
+    dirty = true;
+    meshDirty = true;
+}
+
+namespace {
+    const uint32_t SAVE_MAGIC = 0xDEADBEEF;
+    const uint32_t SAVE_VERSION_FULL = 1;  // whole block array
+    const uint32_t SAVE_VERSION_DELTA = 2; // edit runs over generated terrain
+
+    // Unchanged blocks shorter than this between two edits are folded into one
+    // run; each run costs 4 bytes of header
+    const int RUN_MERGE_GAP = 4;
+
+    struct EditRun {
+        uint16_t start;
+        uint16_t length;
+    };
 }
 
-bool Chunk::Save(const std::string& basePath) const {
+bool Chunk::Save(const std::string& basePath, const BlockId* generated) const {
     try {
+        fs::path filepath = fs::path(basePath) / (GetIdentifier() + ".chunk");
+
+        // Runs of blocks that differ from the generated terrain
+        std::vector<EditRun> runs;
+        const int count = static_cast<int>(blocks.size());
+        for (int i = 0; i < count;) {
+            if (blocks[i] == generated[i]) { ++i; continue; }
+            int end = i + 1;
+            for (int j = end; j < count && j - end < RUN_MERGE_GAP; ++j) {
+                if (blocks[j] != generated[j]) end = j + 1;
+            }
+            runs.push_back(EditRun{ static_cast<uint16_t>(i), static_cast<uint16_t>(end - i) });
+            i = end;
+        }
+
+        // Nothing edited (or edits undone): the generator reproduces this chunk
+        if (runs.empty()) {
+            std::error_code ec;
+            if (fs::remove(filepath, ec)) Log::Debug("Chunk::Save - " + GetIdentifier() + " matches generated terrain, removed its save");
+            return !ec;
+        }
+
         // Create directory structure if needed
         fs::path dirPath(basePath);
         if (!fs::exists(dirPath)) {
             fs::create_directories(dirPath);
         }
 
-        // Generate filename from identifier
-        std::string filename = GetIdentifier() + ".chunk";
-        fs::path filepath = dirPath / filename;
-
-        // Open file and write block data
         std::ofstream file(filepath, std::ios::binary);
         if (!file.is_open()) {
             Log::Error("Chunk::Save - Failed to open file: " + filepath.string());
             return false;
         }
 
-        // Write header (magic number + version)
-        uint32_t magic = 0xDEADBEEF;
-        uint32_t version = 1;
-        file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
-        file.write(reinterpret_cast<const char*>(&version), sizeof(version));
-
-        // Write block data
-        size_t blockCount = blocks.size();
-        file.write(reinterpret_cast<const char*>(&blockCount), sizeof(blockCount));
-        file.write(reinterpret_cast<const char*>(blocks.data()), blockCount * sizeof(BlockId));
-
-        // Write coordinate and path info for validation
+        // Write header (magic number + version) and coordinates for validation
+        file.write(reinterpret_cast<const char*>(&SAVE_MAGIC), sizeof(SAVE_MAGIC));
+        file.write(reinterpret_cast<const char*>(&SAVE_VERSION_DELTA), sizeof(SAVE_VERSION_DELTA));
         file.write(reinterpret_cast<const char*>(&coord.x), sizeof(coord.x));
         file.write(reinterpret_cast<const char*>(&coord.y), sizeof(coord.y));
         file.write(reinterpret_cast<const char*>(&coord.z), sizeof(coord.z));
 
+        // Write edit runs: start, length, then the run's block ids
+        uint32_t runCount = static_cast<uint32_t>(runs.size());
+        file.write(reinterpret_cast<const char*>(&runCount), sizeof(runCount));
+        size_t edited = 0;
+        for (const EditRun& run : runs) {
+            file.write(reinterpret_cast<const char*>(&run.start), sizeof(run.start));
+            file.write(reinterpret_cast<const char*>(&run.length), sizeof(run.length));
+            file.write(reinterpret_cast<const char*>(blocks.data() + run.start), run.length * sizeof(BlockId));
+            edited += run.length;
+        }
+
+        const auto bytes = static_cast<size_t>(file.tellp());
         file.close();
-        Log::Info("Chunk::Save - Saved chunk " + GetIdentifier() + " to " + filepath.string());
+        Log::Info("Chunk::Save - Saved chunk " + GetIdentifier() + " to " + filepath.string() + " (" +
+                  std::to_string(runs.size()) + " runs, " + std::to_string(edited) + " blocks, " + std::to_string(bytes) + " bytes)");
         return true;
     }
     catch (const std::exception& e) {
@@ -116,6 +184,11 @@ bool Chunk::Save(const std::string& basePath) const {
     }
 }
 
+bool Chunk::HasSaved(const std::string& basePath) const {
+    std::error_code ec;
+    return fs::exists(fs::path(basePath) / (GetIdentifier() + ".chunk"), ec);
+}
+
 bool Chunk::Load(const std::string& basePath) {
     try {
         // Generate filename from identifier
@@ -140,36 +213,68 @@ bool Chunk::Load(const std::string& basePath) {
         file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
         file.read(reinterpret_cast<char*>(&version), sizeof(version));
 
-        if (magic != 0xDEADBEEF || version != 1) {
+        if (magic != SAVE_MAGIC || (version != SAVE_VERSION_FULL && version != SAVE_VERSION_DELTA)) {
             Log::Error("Chunk::Load - Invalid header (magic: " + std::to_string(magic) + ", version: " + std::to_string(version) + ")");
             file.close();
             return false;
         }
 
-        // Read block data
-        size_t blockCount = 0;
-        file.read(reinterpret_cast<char*>(&blockCount), sizeof(blockCount));
+        // Edits are applied to a copy so a truncated file leaves the generated blocks intact
+        std::vector<BlockId> loaded = blocks;
+        int savedX = 0, savedY = 0, savedZ = 0;
+
+        if (version == SAVE_VERSION_FULL) {
+            // Read block data
+            size_t blockCount = 0;
+            file.read(reinterpret_cast<char*>(&blockCount), sizeof(blockCount));
+
+            if (blockCount != blocks.size()) {
+                Log::Error("Chunk::Load - Block count mismatch (expected " + std::to_string(blocks.size()) + ", got " + std::to_string(blockCount) + ")");
+                file.close();
+                return false;
+            }
+
+            file.read(reinterpret_cast<char*>(loaded.data()), blockCount * sizeof(BlockId));
+
+            // Read coordinate info for validation (but don't fail if it mismatches)
+            file.read(reinterpret_cast<char*>(&savedX), sizeof(savedX));
+            file.read(reinterpret_cast<char*>(&savedY), sizeof(savedY));
+            file.read(reinterpret_cast<char*>(&savedZ), sizeof(savedZ));
+        } else {
+            file.read(reinterpret_cast<char*>(&savedX), sizeof(savedX));
+            file.read(reinterpret_cast<char*>(&savedY), sizeof(savedY));
+            file.read(reinterpret_cast<char*>(&savedZ), sizeof(savedZ));
 
-        if (blockCount != blocks.size()) {
-            Log::Error("Chunk::Load - Block count mismatch (expected " + std::to_string(blocks.size()) + ", got " + std::to_string(blockCount) + ")");
+            uint32_t runCount = 0;
+            file.read(reinterpret_cast<char*>(&runCount), sizeof(runCount));
+            for (uint32_t r = 0; r < runCount && file; ++r) {
+                EditRun run{};
+                file.read(reinterpret_cast<char*>(&run.start), sizeof(run.start));
+                file.read(reinterpret_cast<char*>(&run.length), sizeof(run.length));
+                if (static_cast<size_t>(run.start) + run.length > loaded.size()) {
+                    Log::Error("Chunk::Load - Edit run out of range in " + filepath.string());
+                    file.close();
+                    return false;
+                }
+                file.read(reinterpret_cast<char*>(loaded.data() + run.start), run.length * sizeof(BlockId));
+            }
+        }
+
+        if (!file) {
+            Log::Error("Chunk::Load - Truncated file: " + filepath.string());
             file.close();
             return false;
         }
 
-        file.read(reinterpret_cast<char*>(blocks.data()), blockCount * sizeof(BlockId));
-
-        // Read coordinate info for validation (but don't fail if it mismatches)
-        int savedX = 0, savedY = 0, savedZ = 0;
-        file.read(reinterpret_cast<char*>(&savedX), sizeof(savedX));
-        file.read(reinterpret_cast<char*>(&savedY), sizeof(savedY));
-        file.read(reinterpret_cast<char*>(&savedZ), sizeof(savedZ));
-
         if (savedX != coord.x || savedY != coord.y || savedZ != coord.z) {
             Log::Warning("Chunk::Load - Coordinate mismatch (saved: " + std::to_string(savedX) + "," + std::to_string(savedY) + "," + std::to_string(savedZ) + 
                          ", current: " + std::to_string(coord.x) + "," + std::to_string(coord.y) + "," + std::to_string(coord.z) + ")");
         }
 
+        blocks.swap(loaded);
         file.close();
+        dirty = false;
+        meshDirty = true;
         Log::Info("Chunk::Load - Loaded chunk " + GetIdentifier() + " from " + filepath.string());
         return true;
     }
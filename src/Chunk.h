@@ -1,15 +1,13 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <cstdint>
 #include "include/raylib.h"
 #include "ChunkPath.h"
 #include "WorldGenerator.h"
 #include "Quad.h"
 
 
-typedef unsigned char BlockId;
-
-
 class Chunk {
 public:
 static constexpr int SIZE = 16;
@@ -18,6 +16,15 @@ static constexpr int SIZE = 16;
 bool hasModel = false;
 Model model{};
 std::vector<Quad> quads;
+// Bitmask of chunk face pairs joined through non-solid cells (see ChunkOcclusion).
+// Refreshed whenever the chunk is meshed; all pairs connected until then.
+uint16_t faceConnectivity = 0x7FFF;
+// Render frame in which this chunk was last drawn
+uint32_t visibleFrame = 0;
+// Blocks changed since the last mesh build
+bool meshDirty = true;
+// Size of the uploaded mesh buffers (0 when there is no model)
+size_t meshBytes = 0;
 
 
 Chunk();
@@ -27,6 +34,10 @@ void Init(const ChunkCoord& c);
 void InitWithPath(const ChunkPath& p);
 
 
+// Chunk coordinates addressed by a path (what InitWithPath assigns)
+static ChunkCoord CoordForPath(const ChunkPath& p);
+
+
 void SetPath(const ChunkPath& p);
 const ChunkPath& GetPath() const;
 
@@ -43,12 +54,37 @@ BlockId Get(int x, int y, int z) const;
 void Set(int x, int y, int z, BlockId id);
 
 
-bool Save(const std::string&) const;
+// Raw block storage (SIZE^3, index x + z*SIZE + y*SIZE*SIZE) for bulk fills by generators.
+// Writes through here do not mark the chunk dirty.
+BlockId* Data() { return blocks.data(); }
+const BlockId* Data() const { return blocks.data(); }
+
+
+// True when blocks were edited since the chunk was generated, loaded or saved
+bool IsDirty() const { return dirty; }
+void ClearDirty() { dirty = false; }
+
+
+// Free the GPU model and outline quads; the chunk is remeshed on next use
+void ReleaseModel();
+
+
+// CPU memory held by block data and outline quads
+size_t GetCpuBytes() const;
+
+
+// Saves hold only what differs from `generated` (the generator's output for this
+// chunk): runs of edited blocks. A chunk identical to it has no file at all.
+bool Save(const std::string& basePath, const BlockId* generated) const;
+// Patch the saved edits over the current blocks, which must already hold the
+// generator's output. Also reads older full-copy saves.
 bool Load(const std::string&);
+bool HasSaved(const std::string&) const;
 
 
 private:
 ChunkCoord coord{};
 ChunkPath path;
 std::vector<BlockId> blocks = std::vector<BlockId>(SIZE*SIZE*SIZE, 0);
+bool dirty = false;
 };
@@ -1,37 +1,387 @@
 #include "ChunkManager.h"
 #include "Chunk.h"
 #include "WorldGenerator.h"
-#include "HeightmapGenerator.h"
+#include "GenerationStages.h"
 #include "Log.h"
 #include "GreedyMesher.h"
+#include "ChunkOcclusion.h"
+#include "Config.h"
+#include "ThreadPool.h"
+#include "ChunkStore.h"
+#include "ChunkOctree.h"
 #include <vector>
 #include <memory>
-#include <unordered_map>
+#include <unordered_set>
 #include <string>
+#include <mutex>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
 
 namespace {
-    std::unique_ptr<WorldGenerator> g_generator;
-    std::unordered_map<std::string, std::shared_ptr<Chunk>> g_chunkMap;
-    ChunkRegistry g_registry;
-    static inline std::string KeyFor(int x,int y,int z) { return std::to_string(x) + "," + std::to_string(y) + "," + std::to_string(z); }
+    std::unique_ptr<GenerationPipeline> g_generator;
+    ChunkStore g_store;
+    ChunkOctree g_octree; // aggregate block metadata over g_store
+
+    // Occlusion culling settings and per-frame scratch
+    bool g_occlusionEnabled = true;
+    int g_renderDistance = 8; // in chunks
+    uint32_t g_renderFrame = 0;
+    std::vector<Chunk*> g_visible;
+    ChunkManager::RenderStats g_renderStats;
+
+    // Streaming ring around the camera (radii in chunks, XZ distance)
+    struct StreamSettings {
+        int loadRadius = 6;
+        int unloadRadius = 8;
+        int minY = -1;
+        int maxY = 1;
+        int budget = 8;          // integrate/evict operations per frame
+        float budgetMs = 4.0f;   // main-thread time per frame
+        int maxInFlight = 8;     // generation/load jobs queued on the pool
+        std::string saveDir = "build/world";
+    };
+    StreamSettings g_stream;
+    ChunkCoord g_cameraChunk{};
+    bool g_haveCameraChunk = false;
+    bool g_pendingStale = false;                // an in-ring chunk was dropped since the last rebuild
+    std::vector<ChunkCoord> g_pending;          // sorted farthest-first; nearest is popped from the back
+    std::vector<ChunkCoord> g_evictQueue;
+    std::unordered_set<uint64_t> g_inFlight;      // ChunkStore keys
+    std::mutex g_completedMutex;
+    std::vector<std::shared_ptr<Chunk>> g_completed; // filled by workers
+    std::vector<std::shared_ptr<Chunk>> g_ready;     // drained from g_completed on the main thread
+    size_t g_readyHead = 0;
+    ChunkManager::StreamStats g_streamStats;
+
+    // Main-thread streaming work allowed this frame (operation count and wall time)
+    struct FrameBudget {
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        int work = 0;
+
+        bool Exhausted() const {
+            if (work >= g_stream.budget) return true;
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+            return ms >= g_stream.budgetMs;
+        }
+    };
+
+    // Memory budgets; least-recently-visible chunks lose their mesh first, then their blocks
+    ChunkManager::CacheStats g_cache;
+    bool g_warnedRingOverBudget = false;
+    std::vector<std::pair<uint32_t, Chunk*>> g_lruScratch;
+
+    bool InRing(const ChunkCoord& c, int radius) {
+        if (c.y < g_stream.minY || c.y > g_stream.maxY) return false;
+        int dx = c.x - g_cameraChunk.x;
+        int dz = c.z - g_cameraChunk.z;
+        return dx * dx + dz * dz <= radius * radius;
+    }
+
+    bool IsResident(const ChunkCoord& c) {
+        return g_store.Contains(c);
+    }
+
+    // The cache totals follow each resident chunk's sizes; every change to a
+    // resident chunk's blocks or mesh storage goes between Uncount and Count
+    void Count(const Chunk& ch) {
+        g_cache.cpuBytes += ch.GetCpuBytes();
+        g_cache.gpuBytes += ch.meshBytes;
+    }
+
+    void Uncount(const Chunk& ch) {
+        g_cache.cpuBytes -= std::min(g_cache.cpuBytes, ch.GetCpuBytes());
+        g_cache.gpuBytes -= std::min(g_cache.gpuBytes, ch.meshBytes);
+    }
+
+    // Collect missing chunks inside the load radius, nearest to the camera first
+    void RebuildPending() {
+        g_pending.clear();
+        g_pendingStale = false;
+        const int r = g_stream.loadRadius;
+        for (int dx = -r; dx <= r; ++dx) {
+            for (int dz = -r; dz <= r; ++dz) {
+                if (dx * dx + dz * dz > r * r) continue;
+                for (int y = g_stream.minY; y <= g_stream.maxY; ++y) {
+                    ChunkCoord c{ g_cameraChunk.x + dx, y, g_cameraChunk.z + dz };
+                    if (IsResident(c)) { ++g_cache.blockHits; continue; }
+                    if (g_inFlight.count(ChunkStore::PackKey(c))) continue;
+                    ++g_cache.blockMisses;
+                    g_pending.push_back(c);
+                }
+            }
+        }
+        auto dist2 = [](const ChunkCoord& c) {
+            int dx = c.x - g_cameraChunk.x, dy = c.y - g_cameraChunk.y, dz = c.z - g_cameraChunk.z;
+            return dx * dx + dy * dy + dz * dz;
+        };
+        std::sort(g_pending.begin(), g_pending.end(), [&](const ChunkCoord& a, const ChunkCoord& b) {
+            return dist2(a) > dist2(b);
+        });
+
+        // Column data is only worth keeping for columns that can still stream back in
+        g_generator->GetColumnCache().EvictOutside(g_cameraChunk.x, g_cameraChunk.z, g_stream.unloadRadius);
+
+        g_evictQueue.clear();
+        for (const auto& ch : g_store.GetAll()) {
+            if (!InRing(ch->GetCoord(), g_stream.unloadRadius)) g_evictQueue.push_back(ch->GetCoord());
+        }
+    }
+
+    // Worker side: generate the chunk, then patch in saved edits if it has any
+    void StreamInChunk(ChunkCoord c, WorldGenerator* generator, std::string saveDir) {
+        auto ch = std::make_shared<Chunk>();
+        ch->Init(c);
+        generator->GenerateChunk(c, ch->Data(), Chunk::SIZE);
+        if (ch->HasSaved(saveDir)) ch->Load(saveDir);
+        std::lock_guard<std::mutex> lock(g_completedMutex);
+        g_completed.push_back(std::move(ch));
+    }
+
+    // Only edited chunks are saved; the rest is regenerated from the seed, so a
+    // save directory belongs to the seed it was written with
+    void CheckSaveSeed(uint32_t seed) {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        fs::create_directories(g_stream.saveDir, ec);
+        const fs::path stamp = fs::path(g_stream.saveDir) / "seed.txt";
+        uint32_t saved = 0;
+        if (std::ifstream in(stamp); in >> saved) {
+            if (saved != seed) {
+                Log::Warning("ChunkManager: " + g_stream.saveDir + " was saved with world seed " + std::to_string(saved) +
+                             " but worldgen.seed is " + std::to_string(seed) + "; edited chunks won't line up with regenerated terrain");
+            }
+            return;
+        }
+        std::ofstream out(stamp);
+        if (out) out << seed << "\n";
+        else Log::Warning("ChunkManager: could not write " + stamp.string());
+    }
+
+    // Saves store edits against regenerated terrain, so saving costs one generation.
+    // Generation depends only on the seed and the chunk's coordinates, so this is
+    // exactly what the chunk held before any edit.
+    bool SaveChunk(Chunk& ch, const std::string& dir) {
+        static std::vector<BlockId> generated(Chunk::SIZE * Chunk::SIZE * Chunk::SIZE);
+        g_generator->GenerateChunk(ch.GetCoord(), generated.data(), Chunk::SIZE);
+        return ch.Save(dir, generated.data());
+    }
+
+    // Save (if edited) and unload a resident chunk
+    void DropChunk(Chunk* ch) {
+        if (ch->IsDirty()) {
+            if (SaveChunk(*ch, g_stream.saveDir)) ch->ClearDirty();
+            else Log::Warning("ChunkManager: failed to save evicted chunk " + ch->GetIdentifier());
+        }
+        // Budget eviction can drop chunks the camera still needs; they have to stream back in
+        if (InRing(ch->GetCoord(), g_stream.loadRadius)) g_pendingStale = true;
+        Uncount(*ch);
+        ch->ReleaseModel();
+        g_octree.Remove(ch->GetCoord());
+        g_store.Remove(ch->GetCoord());
+    }
+
+    void EvictChunk(const ChunkCoord& c) {
+        // The camera may have come back since the eviction was queued
+        if (InRing(c, g_stream.unloadRadius)) return;
+        Chunk* ch = g_store.Find(c);
+        if (!ch) return;
+        DropChunk(ch);
+        ++g_streamStats.evicted;
+    }
+
+    // Candidates for budget eviction: resident chunks not drawn last frame, oldest first
+    void CollectLeastRecentlyVisible(bool needModel) {
+        g_lruScratch.clear();
+        for (const auto& p : g_store.GetAll()) {
+            Chunk* ch = p.get();
+            if (ch->visibleFrame >= g_renderFrame) continue;
+            if (needModel && ch->meshBytes == 0) continue;
+            g_lruScratch.emplace_back(ch->visibleFrame, ch);
+        }
+        std::sort(g_lruScratch.begin(), g_lruScratch.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+    }
+
+    void EnforceBudgets(FrameBudget& budget) {
+        // Meshes are cheap to rebuild from resident blocks, so they go first
+        if (g_cache.gpuBudget > 0 && g_cache.gpuBytes > g_cache.gpuBudget) {
+            CollectLeastRecentlyVisible(true);
+            for (auto& entry : g_lruScratch) {
+                if (g_cache.gpuBytes <= g_cache.gpuBudget) break;
+                Chunk* ch = entry.second;
+                Uncount(*ch);
+                ch->ReleaseModel();
+                Count(*ch);
+                ++g_cache.meshEvictions;
+            }
+        }
+
+        // Dropping block data may hit the disk, so it shares the streaming budget
+        if (g_cache.cpuBudget > 0 && g_cache.cpuBytes > g_cache.cpuBudget) {
+            CollectLeastRecentlyVisible(false);
+            for (auto& entry : g_lruScratch) {
+                if (g_cache.cpuBytes <= g_cache.cpuBudget || budget.Exhausted()) break;
+                DropChunk(entry.second);
+                ++g_cache.blockEvictions;
+                ++budget.work;
+            }
+        }
+    }
+
+    void IntegrateChunk(const std::shared_ptr<Chunk>& ch) {
+        const ChunkCoord& c = ch->GetCoord();
+        g_inFlight.erase(ChunkStore::PackKey(c));
+        if (!InRing(c, g_stream.unloadRadius) || IsResident(c)) return;
+        if (!GreedyMesher::MeshChunk(*ch)) {
+            Log::Warning("GreedyMesher failed for chunk " + ch->GetIdentifier());
+        }
+        // Count a fresh chunk as just seen so the budget doesn't evict it before its first draw
+        ch->visibleFrame = g_renderFrame;
+        g_store.Insert(ch);
+        g_octree.Update(*ch);
+        Count(*ch);
+        ++g_streamStats.integrated;
+    }
+
+    int FloorDiv(int a, int b) {
+        return a >= 0 ? a / b : -((-a + b - 1) / b);
+    }
+
+    // Distances at which a ray enters and leaves a chunk's box
+    void ChunkSpan(const ChunkCoord& c, const Vector3& o, const Vector3& d, float& tEnter, float& tExit, int& enterAxis) {
+        const int S = Chunk::SIZE;
+        const float origin[3] = { o.x, o.y, o.z };
+        const float dir[3] = { d.x, d.y, d.z };
+        const int base[3] = { c.x * S, c.y * S, c.z * S };
+        tEnter = -INFINITY;
+        tExit = INFINITY;
+        enterAxis = -1;
+        for (int a = 0; a < 3; ++a) {
+            if (std::fabs(dir[a]) < 1e-8f) continue; // parallel; the octree already placed the ray inside this slab
+            float t1 = (base[a] - origin[a]) / dir[a];
+            float t2 = (base[a] + S - origin[a]) / dir[a];
+            if (t1 > t2) std::swap(t1, t2);
+            if (t1 > tEnter) { tEnter = t1; enterAxis = a; }
+            tExit = std::min(tExit, t2);
+        }
+    }
+
+    // Step block by block through one chunk (3D DDA) from distance t to tEnd
+    bool PickInChunk(const Chunk& ch, const Vector3& o, const Vector3& d, float t, float tEnd, int enterAxis, ChunkManager::BlockHit& hit) {
+        const int S = Chunk::SIZE;
+        const ChunkCoord& c = ch.GetCoord();
+        const float origin[3] = { o.x, o.y, o.z };
+        const float dir[3] = { d.x, d.y, d.z };
+        const int base[3] = { c.x * S, c.y * S, c.z * S };
+
+        int cell[3], step[3], normal[3] = { 0, 0, 0 };
+        float tMax[3], tDelta[3];
+        for (int a = 0; a < 3; ++a) {
+            const float p = origin[a] + dir[a] * t;
+            cell[a] = std::clamp(static_cast<int>(std::floor(p)) - base[a], 0, S - 1);
+            step[a] = dir[a] > 0.0f ? 1 : -1;
+            if (std::fabs(dir[a]) < 1e-8f) {
+                tMax[a] = INFINITY;
+                tDelta[a] = INFINITY;
+                continue;
+            }
+            const float boundary = static_cast<float>(base[a] + cell[a] + (step[a] > 0 ? 1 : 0));
+            tMax[a] = (boundary - origin[a]) / dir[a];
+            tDelta[a] = 1.0f / std::fabs(dir[a]);
+        }
+        if (enterAxis >= 0) normal[enterAxis] = -step[enterAxis];
+
+        for (;;) {
+            if (ch.Get(cell[0], cell[1], cell[2]) != Blocks::AIR) {
+                hit = ChunkManager::BlockHit{ base[0] + cell[0], base[1] + cell[1], base[2] + cell[2], normal[0], normal[1], normal[2], t };
+                return true;
+            }
+            const int a = tMax[0] < tMax[1] ? (tMax[0] < tMax[2] ? 0 : 2) : (tMax[1] < tMax[2] ? 1 : 2);
+            t = tMax[a];
+            if (t > tEnd) return false;
+            cell[a] += step[a];
+            if (cell[a] < 0 || cell[a] >= S) return false;
+            tMax[a] += tDelta[a];
+            normal[0] = normal[1] = normal[2] = 0;
+            normal[a] = -step[a];
+        }
+    }
 }
 
 namespace ChunkManager {
-    ChunkRegistry& GetRegistry() {
-        return g_registry;
+    ChunkStore& GetStore() {
+        return g_store;
+    }
+
+    const ChunkOctree& GetOctree() {
+        return g_octree;
+    }
+
+    bool PickBlock(const Vector3& origin, const Vector3& dir, float maxDist, BlockHit& hit) {
+        const float len = std::sqrt(dir.x * dir.x + dir.y * dir.y + dir.z * dir.z);
+        if (len < 1e-6f) return false;
+        const Vector3 d = { dir.x / len, dir.y / len, dir.z / len };
+
+        // The octree hands back the next chunk along the ray that has solid blocks;
+        // if the ray misses all of them, carry on from where it leaves that chunk
+        float t = 0.0f;
+        ChunkCoord c;
+        while (t < maxDist) {
+            const Vector3 from = { origin.x + d.x * t, origin.y + d.y * t, origin.z + d.z * t };
+            if (!g_octree.Raycast(from, d, maxDist - t, c)) return false;
+            float tEnter, tExit;
+            int enterAxis;
+            ChunkSpan(c, origin, d, tEnter, tExit, enterAxis);
+            const float start = std::max(t, tEnter);
+            if (start > t) t = start;
+            else enterAxis = -1; // the ray starts inside this chunk
+            if (const Chunk* ch = g_store.Find(c); ch && PickInChunk(*ch, origin, d, t, std::min(tExit, maxDist), enterAxis, hit)) return true;
+            t = std::max(t, tExit) + 1e-3f;
+        }
+        return false;
+    }
+
+    bool SetBlock(int x, int y, int z, BlockId id) {
+        const int S = Chunk::SIZE;
+        const ChunkCoord c{ FloorDiv(x, S), FloorDiv(y, S), FloorDiv(z, S) };
+        Chunk* ch = g_store.Find(c);
+        if (!ch) return false;
+        if (ch->Get(x - c.x * S, y - c.y * S, z - c.z * S) == id) return true;
+        ch->Set(x - c.x * S, y - c.y * S, z - c.z * S, id);
+        g_octree.Update(*ch);
+        return true;
+    }
+
+    const GenerationPipeline* GetGenerator() {
+        return g_generator.get();
+    }
+
+    const RenderStats& GetRenderStats() {
+        return g_renderStats;
+    }
+
+    const StreamStats& GetStreamStats() {
+        return g_streamStats;
+    }
+
+    const CacheStats& GetCacheStats() {
+        return g_cache;
     }
 
     std::shared_ptr<Chunk> GetChunkByPath(const ChunkPath& path) {
-        return g_registry.Get(path);
+        return g_store.Get(Chunk::CoordForPath(path));
     }
 
     void SaveAllChunks(const std::string& basePath) {
-        auto chunks = g_registry.GetAll();
         int saved = 0;
         int failed = 0;
 
-        for (auto& chunk : chunks) {
-            if (chunk && chunk->Save(basePath)) {
+        for (const auto& ch : g_store.GetAll()) {
+            if (SaveChunk(*ch, basePath)) {
+                ch->ClearDirty();
                 ++saved;
             } else {
                 ++failed;
@@ -39,19 +389,26 @@ namespace ChunkManager {
         }
 
         Log::Info("ChunkManager::SaveAllChunks - Saved " + std::to_string(saved) + " chunks, " + 
-                  std::to_string(failed) + " failed (total " + std::to_string(chunks.size()) + ")");
+                  std::to_string(failed) + " failed (total " + std::to_string(g_store.Size()) + ")");
     }
 
     bool LoadChunk(const ChunkPath& path, const std::string& basePath) {
+        if (!g_generator) {
+            Log::Error("ChunkManager::LoadChunk - called before Init");
+            return false;
+        }
         auto chunk = std::make_shared<Chunk>();
         chunk->InitWithPath(path);
-        
+        g_generator->GenerateChunk(chunk->GetCoord(), chunk->Data(), Chunk::SIZE);
+
         if (chunk->Load(basePath)) {
             if (!GreedyMesher::MeshChunk(*chunk)) {
                 Log::Warning("ChunkManager::LoadChunk - Failed to mesh loaded chunk " + path.ToHexString());
             }
 
-            if (g_registry.Add(chunk)) {
+            if (g_store.Insert(chunk)) {
+                g_octree.Update(*chunk);
+                Count(*chunk);
                 Log::Info("ChunkManager::LoadChunk - Successfully loaded and registered chunk " + path.ToHexString());
                 return true;
             } else {
@@ -65,63 +422,165 @@ namespace ChunkManager {
     }
 
     void Init() {
-        g_generator = std::make_unique<HeightmapGenerator>();
-        // Generate 8x8 = 64 chunks around origin
+        g_generator = GenerationStages::CreateWorldPipeline(GenerationStages::LoadSettings());
+        Log::Info("ChunkManager: world seed " + std::to_string(g_generator->GetSeed()) + ", generation stages " + g_generator->DescribePhases());
+        g_occlusionEnabled = Config::GetBool("chunks.occlusion", g_occlusionEnabled);
+        g_renderDistance = Config::GetInt("chunks.render_distance", g_renderDistance);
+
+        g_stream.loadRadius = std::max(1, Config::GetInt("chunks.load_radius", g_stream.loadRadius));
+        g_stream.unloadRadius = std::max(g_stream.loadRadius + 1, Config::GetInt("chunks.unload_radius", g_stream.unloadRadius));
+        g_stream.minY = Config::GetInt("chunks.min_y", g_stream.minY);
+        g_stream.maxY = std::max(g_stream.minY, Config::GetInt("chunks.max_y", g_stream.maxY));
+        g_stream.budget = std::max(1, Config::GetInt("chunks.stream_budget", g_stream.budget));
+        g_stream.budgetMs = Config::GetFloat("chunks.stream_budget_ms", g_stream.budgetMs);
+        g_stream.saveDir = Config::GetString("chunks.save_dir", g_stream.saveDir);
+        g_stream.maxInFlight = std::max(2, ThreadPool::GetInstance().GetThreadCount() * 2);
+        CheckSaveSeed(g_generator->GetSeed());
+
+        g_cache = CacheStats{};
+        g_cache.cpuBudget = static_cast<size_t>(std::max(0, Config::GetInt("chunks.cache_cpu_mb", 64))) * 1024 * 1024;
+        g_cache.gpuBudget = static_cast<size_t>(std::max(0, Config::GetInt("chunks.cache_gpu_mb", 128))) * 1024 * 1024;
+        g_warnedRingOverBudget = false;
+
+        g_store.Clear();
+        g_octree.Clear();
+        g_pending.clear();
+        g_evictQueue.clear();
+        g_inFlight.clear();
+        g_ready.clear();
+        g_readyHead = 0;
+        g_haveCameraChunk = false;
+        g_pendingStale = false;
+        g_streamStats = StreamStats{};
+
+        Log::Info("ChunkManager: streaming radius " + std::to_string(g_stream.loadRadius) + "/" + std::to_string(g_stream.unloadRadius) +
+                  " chunks, y " + std::to_string(g_stream.minY) + ".." + std::to_string(g_stream.maxY) +
+                  ", saves in " + g_stream.saveDir);
+    }
+
+    void Update(const Vector3& cameraPosition) {
         const int S = Chunk::SIZE;
-        int totalFilled = 0;
-        g_chunkMap.clear();
-        g_registry.Clear();
-        
-        for (int cx = -4; cx <= 3; ++cx) {
-            for (int cz = -4; cz <= 3; ++cz) {
-                int cy = 0;
-                auto ch = std::make_shared<Chunk>();
-                ch->Init(ChunkCoord{cx,cy,cz});
-                ChunkPath p;
-                p.Append(cx, cy, cz);
-                ch->SetPath(p);
-                int volume = S*S*S;
-                std::vector<BlockId> blocks(volume);
-                g_generator->GenerateChunk(ch->GetCoord(), blocks.data(), S);
-                int filled = 0;
-                for (int x = 0; x < S; ++x) for (int y = 0; y < S; ++y) for (int z = 0; z < S; ++z) {
-                    int idx = x + z * S + y * S * S;
-                    ch->Set(x,y,z, blocks[idx]);
-                    if (blocks[idx] != 0) ++filled;
-                }
-                totalFilled += filled;
+        FrameBudget budget;
 
-                if (!GreedyMesher::MeshChunk(*ch)) {
-                    Log::Warning("GreedyMesher failed for chunk " + KeyFor(cx, cy, cz));
-                }
+        ChunkCoord cc{
+            static_cast<int>(std::floor(cameraPosition.x / S)),
+            static_cast<int>(std::floor(cameraPosition.y / S)),
+            static_cast<int>(std::floor(cameraPosition.z / S))
+        };
+        if (!g_haveCameraChunk || g_pendingStale || cc.x != g_cameraChunk.x || cc.y != g_cameraChunk.y || cc.z != g_cameraChunk.z) {
+            g_cameraChunk = cc;
+            g_haveCameraChunk = true;
+            RebuildPending();
+        }
 
-                Log::Info(std::string("Chunk created: ") + ch->GetIdentifier() + 
-                          " at coord (" + std::to_string(cx) + "," + std::to_string(cy) + "," + std::to_string(cz) + ")");
-                
-                g_chunkMap.emplace(KeyFor(cx,cy,cz), ch);
-                
-                g_registry.Add(ch);
-            }
+        g_streamStats.integrated = 0;
+        g_streamStats.evicted = 0;
+
+        // Free memory first, then bring in finished chunks
+        while (!g_evictQueue.empty() && !budget.Exhausted()) {
+            EvictChunk(g_evictQueue.back());
+            g_evictQueue.pop_back();
+            ++budget.work;
+        }
+        EnforceBudgets(budget);
+
+        {
+            std::lock_guard<std::mutex> lock(g_completedMutex);
+            for (auto& ch : g_completed) g_ready.push_back(std::move(ch));
+            g_completed.clear();
         }
-        Log::Info(std::string("Chunks total filled blocks: ") + std::to_string(totalFilled));
+        while (g_readyHead < g_ready.size() && !budget.Exhausted()) {
+            IntegrateChunk(g_ready[g_readyHead]);
+            g_ready[g_readyHead++].reset();
+            ++budget.work;
+        }
+        if (g_readyHead == g_ready.size()) {
+            g_ready.clear();
+            g_readyHead = 0;
+        }
+
+        if (!g_warnedRingOverBudget && g_cache.cpuBudget > 0 && g_pendingStale) {
+            g_warnedRingOverBudget = true;
+            Log::Warning("ChunkManager: chunks.cache_cpu_mb is smaller than the streaming ring; chunks will be regenerated repeatedly");
+        }
+
+        // Keep the pool fed, nearest chunks first
+        while (!g_pending.empty() && static_cast<int>(g_inFlight.size()) < g_stream.maxInFlight) {
+            ChunkCoord c = g_pending.back();
+            g_pending.pop_back();
+            if (!InRing(c, g_stream.loadRadius) || IsResident(c)) continue;
+            if (!g_inFlight.insert(ChunkStore::PackKey(c)).second) continue;
+            WorldGenerator* generator = g_generator.get();
+            std::string saveDir = g_stream.saveDir;
+            ThreadPool::GetInstance().Submit([c, generator, saveDir] { StreamInChunk(c, generator, saveDir); });
+        }
+
+        g_streamStats.pending = static_cast<int>(g_pending.size());
+        g_streamStats.inFlight = static_cast<int>(g_inFlight.size());
     }
 
     void Shutdown() {
+        // Let outstanding jobs finish before tearing down what they reference
+        ThreadPool::GetInstance().WaitIdle();
+        int saved = 0;
+        for (const auto& ch : g_store.GetAll()) {
+            if (ch->IsDirty() && SaveChunk(*ch, g_stream.saveDir)) {
+                ch->ClearDirty();
+                ++saved;
+            }
+        }
+        if (saved > 0) Log::Info("ChunkManager: saved " + std::to_string(saved) + " modified chunks on shutdown");
+
         g_generator.reset();
-        g_chunkMap.clear();
+        g_store.Clear();
+        g_octree.Clear();
+        g_cache.cpuBytes = 0;
+        g_cache.gpuBytes = 0;
+        g_completed.clear();
+        g_ready.clear();
+        g_readyHead = 0;
+        g_pending.clear();
+        g_evictQueue.clear();
+        g_inFlight.clear();
     }
 
     void Render(const Camera& cam) {
-        (void)cam; // cam is unused for now; silence -Werror=unused-parameter
         const int S = Chunk::SIZE;
-        for (auto &p : g_chunkMap) {
-            Chunk* ch = p.second.get();
-            if (!ch->hasModel) {
-                if (!GreedyMesher::MeshChunk(*ch)) {
-                    Log::Warning("GreedyMesher remesh failed for chunk " + KeyFor(ch->GetCoord().x, ch->GetCoord().y, ch->GetCoord().z));
-                    continue;
+        ++g_renderFrame;
+        g_visible.clear();
+
+        float aspect = static_cast<float>(GetScreenWidth()) / static_cast<float>(GetScreenHeight() > 0 ? GetScreenHeight() : 1);
+        ChunkOcclusion::ViewCone cone = ChunkOcclusion::MakeViewCone(cam, aspect);
+
+        if (g_occlusionEnabled) {
+            auto lookup = [](int x, int y, int z) -> Chunk* { return g_store.Find(x, y, z); };
+            ChunkOcclusion::CollectVisible(cam, cone, g_renderDistance, lookup, g_visible);
+        } else {
+            for (const auto& ch : g_store.GetAll()) {
+                const ChunkCoord& c = ch->GetCoord();
+                if (ChunkOcclusion::ChunkInView(cone, c.x, c.y, c.z)) g_visible.push_back(ch.get());
+            }
+        }
+
+        int remeshed = 0;
+        for (Chunk* ch : g_visible) {
+            ch->visibleFrame = g_renderFrame;
+            if (ch->meshDirty) {
+                ++g_cache.meshMisses;
+                // A few remeshes per frame; chunks past that keep drawing their old
+                // mesh (if they still have one) until their turn comes
+                if (remeshed < g_stream.budget) {
+                    ++remeshed;
+                    Uncount(*ch);
+                    if (!GreedyMesher::MeshChunk(*ch)) {
+                        Log::Warning("GreedyMesher remesh failed for chunk " + ch->GetIdentifier());
+                    }
+                    Count(*ch);
                 }
+            } else {
+                ++g_cache.meshHits;
             }
+            if (!ch->hasModel) continue; // all air
 
             Vector3 origin = {
                 static_cast<float>(ch->GetCoord().x * S),
@@ -147,6 +606,18 @@ namespace ChunkManager {
                 DrawLine3D(b, d, outline);
             }
         }
+
+        // Classify everything we skipped so the HUD can show what occlusion saved
+        g_renderStats = RenderStats{};
+        g_renderStats.loaded = static_cast<int>(g_store.Size());
+        g_renderStats.drawn = static_cast<int>(g_visible.size());
+        for (const auto& p : g_store.GetAll()) {
+            const Chunk* ch = p.get();
+            if (ch->visibleFrame == g_renderFrame) continue;
+            const ChunkCoord& c = ch->GetCoord();
+            if (ChunkOcclusion::ChunkInView(cone, c.x, c.y, c.z)) ++g_renderStats.occluded;
+            else ++g_renderStats.outsideView;
+        }
     }
 }
 
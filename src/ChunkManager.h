@@ -1,11 +1,68 @@
 #pragma once
 #include "include/raylib.h"
 #include <vector>
-#include "ChunkRegistry.h"
+#include <cstddef>
+#include <cstdint>
+#include "ChunkStore.h"
+#include "ChunkOctree.h"
+
+class GenerationPipeline;
 
 namespace ChunkManager {
+    // Per-frame chunk rendering counters (for the debug HUD)
+    struct RenderStats {
+        int loaded = 0;      // chunks resident in memory
+        int drawn = 0;       // chunks submitted for drawing
+        int occluded = 0;    // in view but unreachable: behind/under terrain or past render distance
+        int outsideView = 0; // rejected by the view cone
+    };
+
+    // Streaming queue counters (for the debug HUD)
+    struct StreamStats {
+        int pending = 0;    // chunks inside the load radius still waiting for a job
+        int inFlight = 0;   // generation/load jobs running on the thread pool
+        int integrated = 0; // chunks meshed and made resident last frame
+        int evicted = 0;    // chunks unloaded (saved if edited) last frame
+    };
+
+    // Chunk memory accounting and cache counters (for the debug HUD)
+    struct CacheStats {
+        size_t cpuBytes = 0;        // block data + outline quads of resident chunks
+        size_t gpuBytes = 0;        // uploaded mesh buffers
+        size_t cpuBudget = 0;       // 0 == unbounded
+        size_t gpuBudget = 0;
+        uint64_t blockHits = 0;     // chunk wanted by streaming and already resident
+        uint64_t blockMisses = 0;   // chunk had to be loaded or generated
+        uint64_t meshHits = 0;      // visible chunk drawn with its existing mesh
+        uint64_t meshMisses = 0;    // visible chunk needed a (re)mesh
+        uint64_t meshEvictions = 0; // meshes dropped to stay under the GPU budget
+        uint64_t blockEvictions = 0;// chunks dropped to stay under the CPU budget
+    };
+
+    // Solid block found along a pick ray
+    struct BlockHit {
+        int x, y, z;    // world block coordinates
+        int nx, ny, nz; // normal of the face the ray entered through (all 0 if it started inside)
+        float distance; // along the ray, in world units
+    };
+
     void Init();
     void Shutdown();
+    // Stream chunks in and out around the camera, within the per-frame budget
+    void Update(const Vector3& cameraPosition);
     void Render(const Camera& cam);
-    ChunkRegistry& GetRegistry();
-}
\ No newline at end of file
+    // Authoritative set of resident chunks
+    ChunkStore& GetStore();
+    // Nearest solid block of a resident chunk along a ray (world units); empty and
+    // unloaded space is skipped through the octree
+    bool PickBlock(const Vector3& origin, const Vector3& dir, float maxDist, BlockHit& hit);
+    // Edit one block (world block coordinates); false when its chunk isn't resident
+    bool SetBlock(int x, int y, int z, BlockId id);
+    // Occupancy/height/modification summaries over the resident chunks
+    const ChunkOctree& GetOctree();
+    // World generator the streamer uses (stage timings); null before Init
+    const GenerationPipeline* GetGenerator();
+    const RenderStats& GetRenderStats();
+    const StreamStats& GetStreamStats();
+    const CacheStats& GetCacheStats();
+}
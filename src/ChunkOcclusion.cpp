@@ -0,0 +1,187 @@
+#include "ChunkOcclusion.h"
+#include <array>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr int S = Chunk::SIZE;
+
+    const int FACE_DIR[ChunkOcclusion::FACE_COUNT][3] = {
+        { -1, 0, 0 }, { 1, 0, 0 },
+        { 0, -1, 0 }, { 0, 1, 0 },
+        { 0, 0, -1 }, { 0, 0, 1 }
+    };
+
+    inline int Opposite(int face) { return face ^ 1; }
+
+    // Index of the unordered face pair (a,b), a != b, into the 15-bit mask
+    inline int PairBit(int a, int b) {
+        if (a > b) std::swap(a, b);
+        return a * (11 - a) / 2 + (b - a - 1);
+    }
+
+    struct WalkNode {
+        int x, y, z;
+        int8_t from;   // face we entered through (-1 for the camera chunk)
+        uint8_t dirs;  // faces stepped out of so far; never step back against one
+    };
+
+    // Scratch state reused across frames to keep the walk allocation-free
+    constexpr uint8_t EMITTED = 0x40;
+    std::vector<uint8_t> g_entered; // per cell: faces already entered through, plus EMITTED
+    std::vector<WalkNode> g_queue;
+}
+
+uint16_t ChunkOcclusion::ComputeFaceConnectivity(const Chunk& chunk) {
+    constexpr int VOLUME = S * S * S;
+    std::array<uint8_t, VOLUME> seen{};
+    std::array<uint16_t, VOLUME> stack;
+
+    // Mark solids as seen up front; the fill below then only walks open cells
+    int open = 0;
+    for (int y = 0; y < S; ++y)
+        for (int z = 0; z < S; ++z)
+            for (int x = 0; x < S; ++x) {
+                int idx = x + z * S + y * S * S;
+                if (chunk.Get(x, y, z) != 0) seen[idx] = 1;
+                else ++open;
+            }
+    if (open == 0) return 0;
+    if (open == VOLUME) return ALL_FACES_CONNECTED;
+
+    uint16_t result = 0;
+    for (int start = 0; start < VOLUME; ++start) {
+        if (seen[start]) continue;
+        seen[start] = 1;
+        int top = 0;
+        stack[top++] = static_cast<uint16_t>(start);
+        unsigned touched = 0;
+
+        while (top > 0) {
+            int idx = stack[--top];
+            int x = idx % S;
+            int z = (idx / S) % S;
+            int y = idx / (S * S);
+
+            if (x == 0) touched |= 1u << FACE_NEG_X;
+            if (x == S - 1) touched |= 1u << FACE_POS_X;
+            if (y == 0) touched |= 1u << FACE_NEG_Y;
+            if (y == S - 1) touched |= 1u << FACE_POS_Y;
+            if (z == 0) touched |= 1u << FACE_NEG_Z;
+            if (z == S - 1) touched |= 1u << FACE_POS_Z;
+
+            if (x > 0 && !seen[idx - 1]) { seen[idx - 1] = 1; stack[top++] = static_cast<uint16_t>(idx - 1); }
+            if (x < S - 1 && !seen[idx + 1]) { seen[idx + 1] = 1; stack[top++] = static_cast<uint16_t>(idx + 1); }
+            if (z > 0 && !seen[idx - S]) { seen[idx - S] = 1; stack[top++] = static_cast<uint16_t>(idx - S); }
+            if (z < S - 1 && !seen[idx + S]) { seen[idx + S] = 1; stack[top++] = static_cast<uint16_t>(idx + S); }
+            if (y > 0 && !seen[idx - S * S]) { seen[idx - S * S] = 1; stack[top++] = static_cast<uint16_t>(idx - S * S); }
+            if (y < S - 1 && !seen[idx + S * S]) { seen[idx + S * S] = 1; stack[top++] = static_cast<uint16_t>(idx + S * S); }
+        }
+
+        // Every face reached by this open region can see every other one
+        for (int a = 0; a < FACE_COUNT; ++a) {
+            if (!(touched & (1u << a))) continue;
+            for (int b = a + 1; b < FACE_COUNT; ++b) {
+                if (touched & (1u << b)) result |= static_cast<uint16_t>(1u << PairBit(a, b));
+            }
+        }
+        if (result == ALL_FACES_CONNECTED) break;
+    }
+    return result;
+}
+
+bool ChunkOcclusion::FacesConnected(uint16_t connectivity, int faceA, int faceB) {
+    if (faceA == faceB) return true;
+    return (connectivity >> PairBit(faceA, faceB)) & 1u;
+}
+
+ChunkOcclusion::ViewCone ChunkOcclusion::MakeViewCone(const Camera& cam, float aspect) {
+    ViewCone cone{};
+    cone.origin = cam.position;
+    Vector3 f = { cam.target.x - cam.position.x, cam.target.y - cam.position.y, cam.target.z - cam.position.z };
+    float len = std::sqrt(f.x * f.x + f.y * f.y + f.z * f.z);
+    if (len > 1e-6f) { f.x /= len; f.y /= len; f.z /= len; }
+    cone.forward = f;
+
+    if (cam.projection != CAMERA_PERSPECTIVE || len <= 1e-6f) {
+        // No meaningful cone; accept everything
+        cone.cosHalf = -1.0f;
+        cone.sinHalf = 0.0f;
+        return cone;
+    }
+    if (aspect <= 0.0f) aspect = 1.0f;
+    float halfV = cam.fovy * 0.5f * 3.14159265f / 180.0f;
+    float half = std::atan(std::tan(halfV) * std::sqrt(1.0f + aspect * aspect));
+    cone.cosHalf = std::cos(half);
+    cone.sinHalf = std::sin(half);
+    return cone;
+}
+
+bool ChunkOcclusion::ChunkInView(const ViewCone& cone, int cx, int cy, int cz) {
+    if (cone.cosHalf <= -1.0f) return true;
+    const float radius = static_cast<float>(S) * 0.8660254f; // half the cube diagonal
+    Vector3 v = {
+        (static_cast<float>(cx) + 0.5f) * S - cone.origin.x,
+        (static_cast<float>(cy) + 0.5f) * S - cone.origin.y,
+        (static_cast<float>(cz) + 0.5f) * S - cone.origin.z
+    };
+    float dist = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+    if (dist <= radius) return true;
+
+    // Sphere vs cone: visible if the angle to the center minus the sphere's
+    // angular radius is within the cone's half angle
+    float cosT = (v.x * cone.forward.x + v.y * cone.forward.y + v.z * cone.forward.z) / dist;
+    float sinT = std::sqrt(std::max(0.0f, 1.0f - cosT * cosT));
+    float sinA = radius / dist;
+    float cosA = std::sqrt(std::max(0.0f, 1.0f - sinA * sinA));
+    if (cosT >= cosA) return true;
+    return cosT * cosA + sinT * sinA >= cone.cosHalf;
+}
+
+void ChunkOcclusion::CollectVisible(const Camera& cam, const ViewCone& cone, int radius,
+                                    const std::function<Chunk*(int,int,int)>& lookup,
+                                    std::vector<Chunk*>& out) {
+    if (radius < 1) radius = 1;
+    const int side = radius * 2 + 1;
+    g_entered.assign(static_cast<size_t>(side) * side * side, 0);
+    g_queue.clear();
+
+    const int camX = static_cast<int>(std::floor(cam.position.x / S));
+    const int camY = static_cast<int>(std::floor(cam.position.y / S));
+    const int camZ = static_cast<int>(std::floor(cam.position.z / S));
+
+    auto cellIndex = [&](int x, int y, int z) {
+        return (x - camX + radius) + (z - camZ + radius) * side + (y - camY + radius) * side * side;
+    };
+
+    g_entered[cellIndex(camX, camY, camZ)] = 0x3F;
+    g_queue.push_back({ camX, camY, camZ, -1, 0 });
+
+    for (size_t head = 0; head < g_queue.size(); ++head) {
+        WalkNode node = g_queue[head];
+        Chunk* ch = lookup(node.x, node.y, node.z);
+        uint8_t& entered = g_entered[cellIndex(node.x, node.y, node.z)];
+        // Emit once; later arrivals through other faces only keep walking
+        if (ch && !(entered & EMITTED)) out.push_back(ch);
+        entered |= EMITTED;
+
+        uint16_t conn = ch ? ch->faceConnectivity : ALL_FACES_CONNECTED;
+        for (int f = 0; f < FACE_COUNT; ++f) {
+            if (f == node.from) continue;
+            if (node.dirs & (1u << Opposite(f))) continue;
+            if (node.from >= 0 && !FacesConnected(conn, node.from, f)) continue;
+
+            int nx = node.x + FACE_DIR[f][0];
+            int ny = node.y + FACE_DIR[f][1];
+            int nz = node.z + FACE_DIR[f][2];
+            if (std::abs(nx - camX) > radius || std::abs(ny - camY) > radius || std::abs(nz - camZ) > radius) continue;
+
+            uint8_t& nEntered = g_entered[cellIndex(nx, ny, nz)];
+            uint8_t entryBit = static_cast<uint8_t>(1u << Opposite(f));
+            if (nEntered & entryBit) continue;
+            if (nEntered == 0 && !ChunkInView(cone, nx, ny, nz)) continue;
+            nEntered |= entryBit;
+            g_queue.push_back({ nx, ny, nz, static_cast<int8_t>(Opposite(f)), static_cast<uint8_t>(node.dirs | (1u << f)) });
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "Chunk.h"
+#include "include/raylib.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// CPU occlusion culling for terrain chunks.
+//
+// When a chunk is meshed we flood-fill its non-solid cells and record which
+// pairs of its six faces can see each other through the chunk (15 bits). At
+// render time a breadth-first walk starts at the camera's chunk and only steps
+// from face A to face B of a chunk if that pair is connected, never doubling
+// back toward the camera. Chunks the walk cannot reach are hidden behind
+// terrain or buried underground and are skipped.
+namespace ChunkOcclusion {
+    enum Face {
+        FACE_NEG_X = 0,
+        FACE_POS_X,
+        FACE_NEG_Y,
+        FACE_POS_Y,
+        FACE_NEG_Z,
+        FACE_POS_Z,
+        FACE_COUNT
+    };
+
+    constexpr uint16_t ALL_FACES_CONNECTED = 0x7FFF;
+
+    // Compute the face connectivity mask for a chunk (0 == fully solid)
+    uint16_t ComputeFaceConnectivity(const Chunk& chunk);
+    bool FacesConnected(uint16_t connectivity, int faceA, int faceB);
+
+    // Conservative view cone around the camera frustum (covers the frustum's corners)
+    struct ViewCone {
+        Vector3 origin;
+        Vector3 forward;
+        float cosHalf;
+        float sinHalf;
+    };
+    ViewCone MakeViewCone(const Camera& cam, float aspect);
+    bool ChunkInView(const ViewCone& cone, int cx, int cy, int cz);
+
+    // Walk outward from the camera chunk up to 'radius' chunks, appending every
+    // loaded chunk that is reachable through open faces and inside the view cone.
+    // lookup returns the chunk at chunk coordinates or nullptr when not loaded;
+    // unloaded space is treated as open air.
+    void CollectVisible(const Camera& cam, const ViewCone& cone, int radius,
+                        const std::function<Chunk*(int,int,int)>& lookup,
+                        std::vector<Chunk*>& out);
+}
@@ -0,0 +1,245 @@
+#include "ChunkOctree.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr int S = Chunk::SIZE;
+    constexpr int BIAS = 1 << (ChunkOctree::LEVELS - 1);
+    constexpr int ROOT_SIZE = 1 << ChunkOctree::LEVELS;
+
+    inline int Octant(int bx, int by, int bz, int bit) {
+        return ((bx >> bit) & 1) | (((by >> bit) & 1) << 1) | (((bz >> bit) & 1) << 2);
+    }
+
+    inline bool InRange(const ChunkCoord& c) {
+        return c.x >= -BIAS && c.x < BIAS && c.y >= -BIAS && c.y < BIAS && c.z >= -BIAS && c.z < BIAS;
+    }
+
+    ChunkOctree::Summary Summarize(const Chunk& chunk) {
+        ChunkOctree::Summary s;
+        s.chunks = 1;
+        const BlockId* blocks = chunk.Data();
+        const BlockId first = blocks[0];
+        bool uniform = true;
+        const int baseY = chunk.GetCoord().y * S;
+
+        // Blocks are y-major, so each layer is one contiguous run
+        for (int y = 0; y < S; ++y) {
+            const BlockId* layer = blocks + y * S * S;
+            int solid = 0;
+            for (int i = 0; i < S * S; ++i) {
+                solid += layer[i] != 0;
+                uniform &= layer[i] == first;
+            }
+            if (solid == 0) continue;
+            s.solidBlocks += solid;
+            s.minSolidY = std::min(s.minSolidY, baseY + y);
+            s.maxSolidY = baseY + y;
+        }
+        s.uniform = uniform;
+        s.uniformValue = uniform ? first : 0;
+        return s;
+    }
+
+    bool SlabTest(const float bmin[3], const float bmax[3], const Vector3& origin, const Vector3& invDir,
+                  float& tEnter, float& tExit) {
+        const float o[3] = { origin.x, origin.y, origin.z };
+        const float inv[3] = { invDir.x, invDir.y, invDir.z };
+        tEnter = 0.0f;
+        tExit = INFINITY;
+        for (int a = 0; a < 3; ++a) {
+            float t1 = (bmin[a] - o[a]) * inv[a];
+            float t2 = (bmax[a] - o[a]) * inv[a];
+            if (t1 > t2) std::swap(t1, t2);
+            tEnter = std::max(tEnter, t1);
+            tExit = std::min(tExit, t2);
+        }
+        return tEnter <= tExit;
+    }
+}
+
+ChunkOctree::ChunkOctree() {
+    Clear();
+}
+
+void ChunkOctree::Clear() {
+    nodes.clear();
+    freeNodes.clear();
+    Node root{};
+    std::fill(std::begin(root.child), std::end(root.child), -1);
+    nodes.push_back(root);
+    generation = 0;
+}
+
+int32_t ChunkOctree::Alloc() {
+    Node node{};
+    std::fill(std::begin(node.child), std::end(node.child), -1);
+    if (!freeNodes.empty()) {
+        int32_t index = freeNodes.back();
+        freeNodes.pop_back();
+        nodes[index] = node;
+        return index;
+    }
+    nodes.push_back(node);
+    return static_cast<int32_t>(nodes.size() - 1);
+}
+
+void ChunkOctree::Recompute(Node& node) const {
+    Summary s;
+    bool uniform = true;
+    bool haveValue = false;
+    BlockId value = 0;
+    for (int32_t c : node.child) {
+        if (c < 0) continue;
+        const Summary& cs = nodes[c].summary;
+        s.chunks += cs.chunks;
+        s.solidBlocks += cs.solidBlocks;
+        s.minSolidY = std::min(s.minSolidY, cs.minSolidY);
+        s.maxSolidY = std::max(s.maxSolidY, cs.maxSolidY);
+        s.generation = std::max(s.generation, cs.generation);
+        if (!cs.uniform || (haveValue && cs.uniformValue != value)) uniform = false;
+        value = cs.uniformValue;
+        haveValue = true;
+    }
+    s.uniform = haveValue && uniform;
+    s.uniformValue = s.uniform ? value : 0;
+    node.summary = s;
+}
+
+void ChunkOctree::Update(const Chunk& chunk) {
+    const ChunkCoord& c = chunk.GetCoord();
+    if (!InRange(c)) return;
+    const int bx = c.x + BIAS, by = c.y + BIAS, bz = c.z + BIAS;
+
+    int32_t stack[LEVELS + 1];
+    stack[0] = 0;
+    for (int level = 0; level < LEVELS; ++level) {
+        int oct = Octant(bx, by, bz, LEVELS - 1 - level);
+        int32_t next = nodes[stack[level]].child[oct];
+        if (next < 0) {
+            next = Alloc(); // may reallocate nodes
+            nodes[stack[level]].child[oct] = next;
+        }
+        stack[level + 1] = next;
+    }
+
+    Summary leaf = Summarize(chunk);
+    leaf.generation = ++generation;
+    nodes[stack[LEVELS]].summary = leaf;
+    for (int level = LEVELS - 1; level >= 0; --level) Recompute(nodes[stack[level]]);
+}
+
+void ChunkOctree::Remove(const ChunkCoord& c) {
+    if (!InRange(c)) return;
+    const int bx = c.x + BIAS, by = c.y + BIAS, bz = c.z + BIAS;
+
+    int32_t stack[LEVELS + 1];
+    int octs[LEVELS];
+    stack[0] = 0;
+    for (int level = 0; level < LEVELS; ++level) {
+        octs[level] = Octant(bx, by, bz, LEVELS - 1 - level);
+        stack[level + 1] = nodes[stack[level]].child[octs[level]];
+        if (stack[level + 1] < 0) return;
+    }
+
+    // Unlink the leaf, then prune ancestors that no longer index anything
+    bool unlink = true;
+    for (int level = LEVELS - 1; level >= 0; --level) {
+        Node& parent = nodes[stack[level]];
+        if (unlink) {
+            freeNodes.push_back(stack[level + 1]);
+            parent.child[octs[level]] = -1;
+        }
+        Recompute(parent);
+        unlink = parent.summary.chunks == 0;
+    }
+}
+
+const ChunkOctree::Summary* ChunkOctree::Find(const ChunkCoord& c) const {
+    if (!InRange(c)) return nullptr;
+    const int bx = c.x + BIAS, by = c.y + BIAS, bz = c.z + BIAS;
+    int32_t index = 0;
+    for (int level = 0; level < LEVELS && index >= 0; ++level) {
+        index = nodes[index].child[Octant(bx, by, bz, LEVELS - 1 - level)];
+    }
+    return index >= 0 ? &nodes[index].summary : nullptr;
+}
+
+void ChunkOctree::QueryNode(int32_t index, const Box& box, const int lo[3], const int hi[3],
+                            const NodeFilter& filter, const LeafVisitor& visit) const {
+    const Node& node = nodes[index];
+    if (filter && !filter(node.summary)) return;
+    if (box.size == 1) {
+        visit(ChunkCoord{ box.x - BIAS, box.y - BIAS, box.z - BIAS }, node.summary);
+        return;
+    }
+    const int half = box.size / 2;
+    for (int oct = 0; oct < 8; ++oct) {
+        if (node.child[oct] < 0) continue;
+        Box cb{ box.x + (oct & 1) * half, box.y + ((oct >> 1) & 1) * half, box.z + ((oct >> 2) & 1) * half, half };
+        if (cb.x > hi[0] || cb.x + half - 1 < lo[0]) continue;
+        if (cb.y > hi[1] || cb.y + half - 1 < lo[1]) continue;
+        if (cb.z > hi[2] || cb.z + half - 1 < lo[2]) continue;
+        QueryNode(node.child[oct], cb, lo, hi, filter, visit);
+    }
+}
+
+void ChunkOctree::Query(const ChunkCoord& min, const ChunkCoord& max, const NodeFilter& filter, const LeafVisitor& visit) const {
+    const int lo[3] = { std::max(min.x + BIAS, 0), std::max(min.y + BIAS, 0), std::max(min.z + BIAS, 0) };
+    const int hi[3] = { std::min(max.x + BIAS, ROOT_SIZE - 1), std::min(max.y + BIAS, ROOT_SIZE - 1), std::min(max.z + BIAS, ROOT_SIZE - 1) };
+    if (lo[0] > hi[0] || lo[1] > hi[1] || lo[2] > hi[2]) return;
+    QueryNode(0, Box{ 0, 0, 0, ROOT_SIZE }, lo, hi, filter, visit);
+}
+
+bool ChunkOctree::RegionEmpty(const ChunkCoord& min, const ChunkCoord& max) const {
+    bool empty = true;
+    Query(min, max,
+          [&](const Summary& s) { return empty && !s.Empty(); },
+          [&](const ChunkCoord&, const Summary&) { empty = false; });
+    return empty;
+}
+
+void ChunkOctree::ModifiedSince(uint32_t since, const LeafVisitor& visit) const {
+    const ChunkCoord lo{ -BIAS, -BIAS, -BIAS };
+    const ChunkCoord hi{ BIAS - 1, BIAS - 1, BIAS - 1 };
+    Query(lo, hi, [since](const Summary& s) { return s.generation > since; }, visit);
+}
+
+bool ChunkOctree::RaycastNode(int32_t index, const Box& box, const Vector3& origin, const Vector3& invDir,
+                              float maxDist, ChunkCoord& hit) const {
+    const Node& node = nodes[index];
+    if (node.summary.Empty()) return false;
+    if (box.size == 1) {
+        hit = ChunkCoord{ box.x - BIAS, box.y - BIAS, box.z - BIAS };
+        return true;
+    }
+
+    // Children in the order the ray enters them; the first hit is the nearest
+    struct Entry { float t; int oct; Box box; };
+    Entry order[8];
+    int count = 0;
+    const int half = box.size / 2;
+    for (int oct = 0; oct < 8; ++oct) {
+        int32_t c = node.child[oct];
+        if (c < 0 || nodes[c].summary.Empty()) continue;
+        Box cb{ box.x + (oct & 1) * half, box.y + ((oct >> 1) & 1) * half, box.z + ((oct >> 2) & 1) * half, half };
+        const float bmin[3] = { float(cb.x - BIAS) * S, float(cb.y - BIAS) * S, float(cb.z - BIAS) * S };
+        const float bmax[3] = { bmin[0] + float(half) * S, bmin[1] + float(half) * S, bmin[2] + float(half) * S };
+        float tEnter, tExit;
+        if (!SlabTest(bmin, bmax, origin, invDir, tEnter, tExit) || tEnter > maxDist) continue;
+        int i = count++;
+        while (i > 0 && order[i - 1].t > tEnter) { order[i] = order[i - 1]; --i; }
+        order[i] = Entry{ tEnter, oct, cb };
+    }
+    for (int i = 0; i < count; ++i) {
+        if (RaycastNode(node.child[order[i].oct], order[i].box, origin, invDir, maxDist, hit)) return true;
+    }
+    return false;
+}
+
+bool ChunkOctree::Raycast(const Vector3& origin, const Vector3& dir, float maxDist, ChunkCoord& hit) const {
+    // Large finite reciprocals keep axis-parallel rays out of inf*0 territory
+    auto inv = [](float d) { return std::fabs(d) > 1e-8f ? 1.0f / d : 1e30f; };
+    Vector3 invDir = { inv(dir.x), inv(dir.y), inv(dir.z) };
+    return RaycastNode(0, Box{ 0, 0, 0, ROOT_SIZE }, origin, invDir, maxDist, hit);
+}
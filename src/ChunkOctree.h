@@ -0,0 +1,76 @@
+#pragma once
+#include "Chunk.h"
+#include "include/raylib.h"
+#include <climits>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Sparse octree over resident chunk coordinates.
+//
+// A node's octant path is read from the bits of the (biased) chunk
+// coordinates, most significant bit first. Only subtrees that contain an
+// indexed chunk are allocated. Every node aggregates its subtree, so culling,
+// LOD, raycast and save passes can skip empty or untouched regions without
+// visiting their chunks.
+class ChunkOctree {
+public:
+    static constexpr int LEVELS = 21; // 2^21 chunks per axis, the ChunkStore key range
+
+    struct Summary {
+        uint32_t chunks = 0;      // indexed chunks in the subtree
+        uint64_t solidBlocks = 0; // occupancy
+        bool uniform = false;     // every indexed block holds uniformValue
+        BlockId uniformValue = 0;
+        int minSolidY = INT_MAX;  // world block Y of the lowest/highest solid block
+        int maxSolidY = INT_MIN;
+        uint32_t generation = 0;  // newest modification in the subtree
+
+        bool Empty() const { return solidBlocks == 0; }
+    };
+
+    using NodeFilter = std::function<bool(const Summary&)>;
+    using LeafVisitor = std::function<void(const ChunkCoord&, const Summary&)>;
+
+    ChunkOctree();
+
+    // (Re)summarize a chunk's blocks and stamp it with a new generation
+    void Update(const Chunk& chunk);
+    void Remove(const ChunkCoord& c);
+    void Clear();
+
+    const Summary& GetRoot() const { return nodes[0].summary; }
+    const Summary* Find(const ChunkCoord& c) const;
+    uint32_t GetGeneration() const { return generation; }
+
+    // Visit indexed chunks inside [min, max] (inclusive); subtrees rejected by the filter are skipped whole
+    void Query(const ChunkCoord& min, const ChunkCoord& max, const NodeFilter& filter, const LeafVisitor& visit) const;
+    // True if no indexed chunk inside [min, max] has a solid block
+    bool RegionEmpty(const ChunkCoord& min, const ChunkCoord& max) const;
+    // Visit chunks updated after the given generation
+    void ModifiedSince(uint32_t since, const LeafVisitor& visit) const;
+    // Nearest indexed chunk with solid blocks along a ray (world units)
+    bool Raycast(const Vector3& origin, const Vector3& dir, float maxDist, ChunkCoord& hit) const;
+
+private:
+    struct Node {
+        int32_t child[8];
+        Summary summary;
+    };
+
+    struct Box {
+        int x, y, z; // biased chunk coordinates of the minimum corner
+        int size;    // edge length in chunks
+    };
+
+    int32_t Alloc();
+    void Recompute(Node& node) const;
+    void QueryNode(int32_t index, const Box& box, const int lo[3], const int hi[3],
+                   const NodeFilter& filter, const LeafVisitor& visit) const;
+    bool RaycastNode(int32_t index, const Box& box, const Vector3& origin, const Vector3& invDir,
+                     float maxDist, ChunkCoord& hit) const;
+
+    std::vector<Node> nodes; // nodes[0] is the root
+    std::vector<int32_t> freeNodes;
+    uint32_t generation = 0;
+};
@@ -1,96 +1,138 @@
 #include "ChunkPath.h"
-#include <sstream>
-#include <iomanip>
+#include "Log.h"
 
-ChunkPath::ChunkPath(const std::vector<uint8_t>& pathIndices)
-    : path(pathIndices) {
+namespace {
+    // Spread the biased triple's bits into bit planes, high plane first:
+    // x2 y2 | x1 y1 z1 | x0 y0 z0 (z only has two bits)
+    inline uint8_t Interleave(unsigned x, unsigned y, unsigned z) {
+        return static_cast<uint8_t>(
+            ((x >> 2 & 1) << 7) | ((y >> 2 & 1) << 6) |
+            ((x >> 1 & 1) << 5) | ((y >> 1 & 1) << 4) | ((z >> 1 & 1) << 3) |
+            ((x & 1) << 2) | ((y & 1) << 1) | (z & 1));
+    }
+
+    inline int FromHexDigit(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    // Components are written as one two's-complement nibble each
+    inline char ToHexDigit(int v) {
+        return "0123456789abcdef"[v & 0xF];
+    }
 }
 
 uint8_t ChunkPath::EncodeTriple(int x, int y, int z) {
     // Clamp to ranges: x -4 to 3 (3 bits), y -4 to 3 (3 bits), z -2 to 1 (2 bits)
-    x = (x + 4) & 0x7;  // 3 bits
-    y = (y + 4) & 0x7;  // 3 bits
-    z = (z + 2) & 0x3;  // 2 bits
-    
-    return (uint8_t)((x << 5) | (y << 2) | z);
+    unsigned ux = static_cast<unsigned>(x + 4) & 0x7;
+    unsigned uy = static_cast<unsigned>(y + 4) & 0x7;
+    unsigned uz = static_cast<unsigned>(z + 2) & 0x3;
+    return Interleave(ux, uy, uz);
 }
 
 void ChunkPath::DecodeTriple(uint8_t encoded, int& x, int& y, int& z) {
-    x = ((encoded >> 5) & 0x7) - 4;   // 3 bits
-    y = ((encoded >> 2) & 0x7) - 4;   // 3 bits
-    z = ((encoded >> 0) & 0x3) - 2;   // 2 bits
+    unsigned e = encoded;
+    unsigned ux = ((e >> 7 & 1) << 2) | ((e >> 5 & 1) << 1) | (e >> 2 & 1);
+    unsigned uy = ((e >> 6 & 1) << 2) | ((e >> 4 & 1) << 1) | (e >> 1 & 1);
+    unsigned uz = ((e >> 3 & 1) << 1) | (e & 1);
+    x = static_cast<int>(ux) - 4;
+    y = static_cast<int>(uy) - 4;
+    z = static_cast<int>(uz) - 2;
 }
 
 void ChunkPath::Append(int x, int y, int z) {
-    path.push_back(EncodeTriple(x, y, z));
+    AppendEncoded(EncodeTriple(x, y, z));
 }
 
 void ChunkPath::AppendEncoded(uint8_t encoded) {
-    path.push_back(encoded);
+    if (depth >= MAX_DEPTH) {
+        Log::Error("ChunkPath::Append - Path is already " + std::to_string(MAX_DEPTH) + " levels deep");
+        return;
+    }
+    code |= static_cast<uint64_t>(encoded) << ((MAX_DEPTH - 1 - depth) * 8);
+    ++depth;
 }
 
 std::string ChunkPath::ToHexString() const {
-    if (path.empty()) {
+    if (depth == 0) {
         return "ROOT";
     }
-    
-    std::ostringstream oss;
-    for (size_t i = 0; i < path.size(); ++i) {
-        if (i > 0) oss << "_";
-        
+
+    std::string out;
+    out.reserve(depth * 4);
+    for (int i = 0; i < depth; ++i) {
+        if (i > 0) out += '_';
+
         int x, y, z;
-        DecodeTriple(path[i], x, y, z);
-        
-        // Hex output
-        oss << std::hex << std::setfill('0')
-            << std::setw(1) << x
-            << std::setw(1) << y
-            << std::setw(1) << z;
+        DecodeTriple(GetStep(i), x, y, z);
+        out += ToHexDigit(x);
+        out += ToHexDigit(y);
+        out += ToHexDigit(z);
     }
-    
-    return oss.str();
+    return out;
 }
 
 ChunkPath ChunkPath::FromHexString(const std::string& hexStr) {
     if (hexStr == "ROOT") {
         return ChunkPath();
     }
-    
+
     ChunkPath result;
-    std::istringstream iss(hexStr);
-    std::string token;
-    
-    while (std::getline(iss, token, '_')) {
-        if (token.length() != 3) continue;
-        
-        int x = std::stoi(token.substr(0, 1), nullptr, 16);
-        int y = std::stoi(token.substr(1, 1), nullptr, 16);
-        int z = std::stoi(token.substr(2, 1), nullptr, 16);
-        
-        result.Append(x, y, z);
+    size_t start = 0;
+    while (start <= hexStr.size()) {
+        size_t end = hexStr.find('_', start);
+        if (end == std::string::npos) end = hexStr.size();
+
+        if (end - start == 3) {
+            int v[3];
+            bool ok = true;
+            for (int k = 0; k < 3; ++k) {
+                v[k] = FromHexDigit(hexStr[start + k]);
+                if (v[k] < 0) ok = false;
+                else if (v[k] >= 8) v[k] -= 16; // sign-extend the nibble
+            }
+            if (ok) result.Append(v[0], v[1], v[2]);
+        }
+        start = end + 1;
     }
-    
+
     return result;
 }
 
 ChunkPath ChunkPath::GetParent() const {
-    if (path.empty()) {
+    if (depth == 0) {
         return ChunkPath(); // Root has no parent
     }
-    
-    std::vector<uint8_t> parentPath(path.begin(), path.end() - 1);
-    return ChunkPath(parentPath);
+
+    ChunkPath parent;
+    parent.depth = static_cast<uint8_t>(depth - 1);
+    parent.code = code & PrefixMask(parent.depth);
+    return parent;
 }
 
-uint32_t ChunkPath::Hash() const {
-    // Simple hash: combine all bytes
-    uint32_t hash = 0;
-    for (size_t i = 0; i < path.size(); ++i) {
-        hash = hash * 31 + path[i];
-    }
-    return hash;
+ChunkPath ChunkPath::FromMorton(uint64_t morton, int depth) {
+    ChunkPath p;
+    if (depth < 0) depth = 0;
+    if (depth > MAX_DEPTH) depth = MAX_DEPTH;
+    p.depth = static_cast<uint8_t>(depth);
+    p.code = morton & PrefixMask(depth);
+    return p;
+}
+
+uint64_t ChunkPath::DescendantsEnd() const {
+    if (depth == 0) return 0;
+    return code + (1ull << ((MAX_DEPTH - depth) * 8));
 }
 
-bool ChunkPath::operator==(const ChunkPath& other) const {
-    return path == other.path;
+uint32_t ChunkPath::Hash() const {
+    // splitmix64 finalizer over code and depth
+    uint64_t h = code ^ (static_cast<uint64_t>(depth) * 0x9E3779B97F4A7C15ull);
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    return static_cast<uint32_t>(h);
 }
@@ -1,5 +1,4 @@
 #pragma once
-#include <vector>
 #include <string>
 #include <cstdint>
 
@@ -8,23 +7,37 @@
  * Like a file path, starts from root with child selections.
  * Unlike player-relative positions, this never changes with movement.
  * Example: "7a3_221" navigates through nested chunks.
+ *
+ * Stored inline: one byte per step packed into a 64-bit word, root step in
+ * the most significant byte, plus the depth. Each step byte interleaves the
+ * bits of its (x,y,z) triple, so the word is a Morton (Z-order) code of the
+ * path: every descendant of a path falls in one contiguous integer range.
  */
 class ChunkPath {
 public:
+    static constexpr int MAX_DEPTH = 8;
+
     ChunkPath() = default;
-    explicit ChunkPath(const std::vector<uint8_t>& pathIndices);
 
     // Encode a single (x,y,z) triple into a byte for the path
     // x: -4 to 3 (3 bits), y: -4 to 3 (3 bits), z: -2 to 1 (2 bits)
     static uint8_t EncodeTriple(int x, int y, int z);
-    
+
     // Decode a byte from path back into (x,y,z)
     static void DecodeTriple(uint8_t encoded, int& x, int& y, int& z);
 
-    // Add a child chunk to the path (append a block coordinate)
+    // Add a child chunk to the path (append a block coordinate).
+    // Ignored (with an error logged) once the path is MAX_DEPTH deep.
     void Append(int x, int y, int z);
     void AppendEncoded(uint8_t encoded);
 
+    // Path one level down
+    ChunkPath GetChild(uint8_t encoded) const {
+        ChunkPath c = *this;
+        c.AppendEncoded(encoded);
+        return c;
+    }
+
     // Get the hex string representation (e.g., "7a3_221")
     std::string ToHexString() const;
 
@@ -32,24 +45,44 @@ public:
     static ChunkPath FromHexString(const std::string& hexStr);
 
     // Get depth (level) of this chunk in the tree
-    int GetDepth() const { return path.size(); }
+    int GetDepth() const { return depth; }
+
+    // Encoded step at the given level (0 = child of root)
+    uint8_t GetStep(int level) const {
+        return static_cast<uint8_t>(code >> ((MAX_DEPTH - 1 - level) * 8));
+    }
 
     // Get parent path (one level up)
     ChunkPath GetParent() const;
 
+    // True if this path is other or one of its ancestors
+    bool IsAncestorOf(const ChunkPath& other) const {
+        return depth <= other.depth && (other.code & PrefixMask(depth)) == code;
+    }
+
+    // Morton code of the path; unused trailing levels are zero
+    uint64_t ToMorton() const { return code; }
+    static ChunkPath FromMorton(uint64_t morton, int depth);
+
+    // Half-open Morton range [first, last) covering this path and all descendants
+    uint64_t DescendantsBegin() const { return code; }
+    uint64_t DescendantsEnd() const; // 0 means "to the end of the key space"
+
     // Compute a hash for fast lookup
     uint32_t Hash() const;
 
     // Comparison
-    bool operator==(const ChunkPath& other) const;
+    bool operator==(const ChunkPath& other) const { return code == other.code && depth == other.depth; }
     bool operator!=(const ChunkPath& other) const { return !(*this == other); }
 
-    // Access underlying path
-    const std::vector<uint8_t>& GetPath() const { return path; }
-
     // Check if this is the root path
-    bool IsRoot() const { return path.empty(); }
+    bool IsRoot() const { return depth == 0; }
 
 private:
-    std::vector<uint8_t> path; // Each byte encodes (x,y,z) triple
+    static uint64_t PrefixMask(int levels) {
+        return levels == 0 ? 0 : ~0ull << ((MAX_DEPTH - levels) * 8);
+    }
+
+    uint64_t code = 0;
+    uint8_t depth = 0;
 };
@@ -0,0 +1,131 @@
+#include "ChunkStore.h"
+
+namespace {
+    constexpr size_t INITIAL_SLOTS = 1024;
+
+    // splitmix64 finalizer: spreads neighboring coordinates across the table
+    inline uint64_t Mix(uint64_t k) {
+        k ^= k >> 30;
+        k *= 0xBF58476D1CE4E5B9ull;
+        k ^= k >> 27;
+        k *= 0x94D049BB133111EBull;
+        k ^= k >> 31;
+        return k;
+    }
+}
+
+ChunkStore::ChunkStore() {
+    slots.assign(INITIAL_SLOTS, Slot{ 0, EMPTY });
+}
+
+uint64_t ChunkStore::PackKey(int x, int y, int z) {
+    const uint64_t mask = 0x1FFFFF; // 21 bits per axis (+-1M chunks)
+    return ((static_cast<uint64_t>(x) & mask) << 42) |
+           ((static_cast<uint64_t>(y) & mask) << 21) |
+           (static_cast<uint64_t>(z) & mask);
+}
+
+size_t ChunkStore::Home(uint64_t key) const {
+    return static_cast<size_t>(Mix(key)) & (slots.size() - 1);
+}
+
+size_t ChunkStore::FindSlot(uint64_t key) const {
+    const size_t mask = slots.size() - 1;
+    for (size_t i = Home(key);; i = (i + 1) & mask) {
+        const Slot& s = slots[i];
+        if (s.index == EMPTY) return slots.size();
+        if (s.key == key) return i;
+    }
+}
+
+bool ChunkStore::Insert(const std::shared_ptr<Chunk>& chunk) {
+    if (!chunk) return false;
+    if ((dense.size() + 1) * 2 > slots.size()) Grow();
+
+    const uint64_t key = PackKey(chunk->GetCoord());
+    const size_t mask = slots.size() - 1;
+    size_t i = Home(key);
+    for (; slots[i].index != EMPTY; i = (i + 1) & mask) {
+        if (slots[i].key == key) return false;
+    }
+    slots[i] = Slot{ key, static_cast<uint32_t>(dense.size()) };
+    dense.push_back(chunk);
+    denseKeys.push_back(key);
+    denseSerials.push_back(nextSerial++);
+    return true;
+}
+
+std::shared_ptr<Chunk> ChunkStore::Remove(const ChunkCoord& c) {
+    const uint64_t key = PackKey(c);
+    size_t i = FindSlot(key);
+    if (i == slots.size()) return nullptr;
+
+    const uint32_t index = slots[i].index;
+    std::shared_ptr<Chunk> removed = std::move(dense[index]);
+
+    // Backward-shift deletion keeps probe chains intact without tombstones
+    const size_t mask = slots.size() - 1;
+    size_t j = i;
+    while (true) {
+        j = (j + 1) & mask;
+        if (slots[j].index == EMPTY) break;
+        size_t k = Home(slots[j].key);
+        bool movable = (i <= j) ? (k <= i || k > j) : (k <= i && k > j);
+        if (movable) {
+            slots[i] = slots[j];
+            i = j;
+        }
+    }
+    slots[i].index = EMPTY;
+
+    // Swap-remove from the dense array and repoint the moved chunk's slot
+    const uint32_t last = static_cast<uint32_t>(dense.size() - 1);
+    if (index != last) {
+        dense[index] = std::move(dense[last]);
+        denseKeys[index] = denseKeys[last];
+        denseSerials[index] = denseSerials[last];
+        slots[FindSlot(denseKeys[index])].index = index;
+    }
+    dense.pop_back();
+    denseKeys.pop_back();
+    denseSerials.pop_back();
+    return removed;
+}
+
+Chunk* ChunkStore::Find(int x, int y, int z) const {
+    size_t i = FindSlot(PackKey(x, y, z));
+    if (i == slots.size()) return nullptr;
+    return dense[slots[i].index].get();
+}
+
+Chunk* ChunkStore::Find(int x, int y, int z, Ref& ref) const {
+    size_t i = FindSlot(PackKey(x, y, z));
+    if (i == slots.size()) return nullptr;
+    ref = Ref{ slots[i].index, denseSerials[slots[i].index] };
+    return dense[ref.index].get();
+}
+
+std::shared_ptr<Chunk> ChunkStore::Get(const ChunkCoord& c) const {
+    size_t i = FindSlot(PackKey(c));
+    if (i == slots.size()) return nullptr;
+    return dense[slots[i].index];
+}
+
+void ChunkStore::Clear() {
+    slots.assign(INITIAL_SLOTS, Slot{ 0, EMPTY });
+    dense.clear();
+    denseKeys.clear();
+    denseSerials.clear();
+}
+
+void ChunkStore::Grow() {
+    std::vector<Slot> old = std::move(slots);
+    slots.assign(old.size() * 2, Slot{ 0, EMPTY });
+    const size_t mask = slots.size() - 1;
+    for (const Slot& s : old) {
+        if (s.index == EMPTY) continue;
+        size_t i = Home(s.key);
+        while (slots[i].index != EMPTY) i = (i + 1) & mask;
+        slots[i] = s;
+    }
+}
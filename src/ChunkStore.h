@@ -0,0 +1,69 @@
+#pragma once
+#include "Chunk.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// The authoritative set of resident chunks, keyed by chunk coordinates.
+//
+// Keys are the three coordinates packed into one 64-bit integer (21 bits per
+// axis). Lookups go through an open-addressing table (linear probing,
+// backward-shift deletion) that maps a key to an index into a dense array of
+// live chunks, so lookups never allocate and iteration is a linear walk.
+// Removal swaps the last chunk into the freed slot, so iteration order is not stable.
+class ChunkStore {
+public:
+    ChunkStore();
+
+    static uint64_t PackKey(int x, int y, int z);
+    static uint64_t PackKey(const ChunkCoord& c) { return PackKey(c.x, c.y, c.z); }
+
+    // Insert a chunk under its own coordinates. Returns false if that slot is taken.
+    bool Insert(const std::shared_ptr<Chunk>& chunk);
+    // Remove and return the chunk at the coordinates (nullptr if absent)
+    std::shared_ptr<Chunk> Remove(const ChunkCoord& c);
+
+    // Names one chunk for as long as it stays at the same place in the dense
+    // array: its index there plus a serial that Insert never hands out twice.
+    // Removing that chunk, or another removal moving it, makes the ref stale.
+    struct Ref {
+        uint32_t index = 0;
+        uint64_t serial = 0; // 0 never matches
+    };
+
+    Chunk* Find(int x, int y, int z) const;
+    Chunk* Find(const ChunkCoord& c) const { return Find(c.x, c.y, c.z); }
+    // Find that also fills in a Ref for the chunk (left as is when absent)
+    Chunk* Find(int x, int y, int z, Ref& ref) const;
+    // The chunk a Ref names, or nullptr once the ref is stale. Two array reads,
+    // no hashing, so callers can hold on to a chunk across frames.
+    Chunk* Resolve(const Ref& ref) const {
+        return ref.index < denseSerials.size() && denseSerials[ref.index] == ref.serial ? dense[ref.index].get() : nullptr;
+    }
+    std::shared_ptr<Chunk> Get(const ChunkCoord& c) const;
+    bool Contains(const ChunkCoord& c) const { return Find(c) != nullptr; }
+
+    // Dense array of live chunks
+    const std::vector<std::shared_ptr<Chunk>>& GetAll() const { return dense; }
+    size_t Size() const { return dense.size(); }
+
+    void Clear();
+
+private:
+    static constexpr uint32_t EMPTY = 0xFFFFFFFFu;
+
+    struct Slot {
+        uint64_t key;
+        uint32_t index; // into dense, EMPTY when unused
+    };
+
+    size_t FindSlot(uint64_t key) const; // returns slots.size() when absent
+    size_t Home(uint64_t key) const;
+    void Grow();
+
+    std::vector<Slot> slots; // power-of-two sized, kept at most half full
+    std::vector<std::shared_ptr<Chunk>> dense;
+    std::vector<uint64_t> denseKeys;
+    std::vector<uint64_t> denseSerials; // Ref serial of each dense chunk
+    uint64_t nextSerial = 1;
+};
@@ -1,94 +1,145 @@
 #include "CollisionSystem.h"
+#include "ArchetypeManager.h"
+#include "Config.h"
 #include "EventManager.h"
+#include "ThreadPool.h"
+#include <algorithm>
 #include <cstdint>
-#include <cmath>
-#include <unordered_map>
-#include <unordered_set>
-#include <vector>
+#include <limits>
 
-// Spatial hash broad-phase parameters
-static const float CELL_SIZE = 1.0f; // world units per cell; tune as needed
+namespace {
+    // Broad phase work items (grid cells, sweep positions) per chunk, and the
+    // most chunks one check is split into
+    constexpr size_t ITEMS_PER_CHUNK = 1024;
+    constexpr size_t MAX_CHUNKS = 64;
 
-// Helper to hash 2D cell coordinates into a single int64 key
-static inline int64_t CellKey(int x, int y) {
-    return (static_cast<int64_t>(x) << 32) ^ static_cast<uint32_t>(y);
+    uint64_t PairKey(uint32_t a, uint32_t b) {
+        return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+    }
+
+    ContactPair PairOf(uint64_t key) {
+        return ContactPair{ EntityHandle{ static_cast<uint32_t>(key >> 32) }, EntityHandle{ static_cast<uint32_t>(key) } };
+    }
+}
+
+void CollisionSystem::SetStayInterval(ArchetypeId a, ArchetypeId b, float seconds) {
+    stayIntervals[PairKey(a, b)] = seconds;
 }
 
-// Check all active entities for collisions and fire events using spatial hashing
-void CollisionSystem::CheckCollisions(std::vector<Entity>& entities) {
-    static std::unordered_map<int64_t, std::vector<size_t>> buckets;
-    buckets.clear();
-    buckets.reserve(entities.size() * 2);
+void CollisionSystem::ClearContacts() {
+    contacts.clear();
+}
 
-    // Track active collision pairs across frames to avoid spamming the same
-    // collision event while two entities remain in contact.
-    static std::unordered_set<uint64_t> activePairs;
-    std::unordered_set<uint64_t> currentFramePairs;
+// Looked up once per new contact: collision.stay_interval.<a>.<b> (either order),
+// falling back to collision.stay_interval. Cached per archetype pair.
+float CollisionSystem::StayInterval(const EntityWorld& world, uint64_t key) {
+    const ContactPair pair = PairOf(key);
+    const Spawned* sa = world.Get<Spawned>(pair.a);
+    const Spawned* sb = world.Get<Spawned>(pair.b);
+    const ArchetypeId a = sa ? sa->archetype : INVALID_ARCHETYPE;
+    const ArchetypeId b = sb ? sb->archetype : INVALID_ARCHETYPE;
+    const uint64_t type = PairKey(a, b);
+    auto it = stayIntervals.find(type);
+    if (it != stayIntervals.end()) return it->second;
 
-    // Insert entities into buckets based on their AABB centers
-    for (size_t i = 0; i < entities.size(); ++i) {
-        if (!entities[i].is_active) continue;
-        float cx = (entities[i].bounds.min.x + entities[i].bounds.max.x) * 0.5f;
-        float cz = (entities[i].bounds.min.z + entities[i].bounds.max.z) * 0.5f;
-        int cellX = static_cast<int>(std::floor(cx / CELL_SIZE));
-        int cellZ = static_cast<int>(std::floor(cz / CELL_SIZE));
-        int64_t key = CellKey(cellX, cellZ);
-        auto &vec = buckets[key];
-        if (vec.capacity() == 0) vec.reserve(4);
-        vec.push_back(i);
+    float seconds = Config::GetFloat("collision.stay_interval", 0.5f);
+    const ArchetypeManager& archetypes = ArchetypeManager::GetInstance();
+    const std::string& nameA = archetypes.GetArchetypeName(a);
+    const std::string& nameB = archetypes.GetArchetypeName(b);
+    if (!nameA.empty() && !nameB.empty()) {
+        seconds = Config::GetFloat("collision.stay_interval." + nameA + "." + nameB,
+                                   Config::GetFloat("collision.stay_interval." + nameB + "." + nameA, seconds));
     }
+    stayIntervals.emplace(type, seconds);
+    return seconds;
+}
 
-    // For each occupied cell, test entities within the cell and neighboring cells
-    for (const auto &entry : buckets) {
-        int64_t key = entry.first;
-        int cellX = static_cast<int>(key >> 32);
-        int cellZ = static_cast<int>(static_cast<uint32_t>(key & 0xffffffff));
-
-        for (int dx = -1; dx <= 1; ++dx) {
-            for (int dz = -1; dz <= 1; ++dz) {
-                int64_t neighborKey = CellKey(cellX + dx, cellZ + dz);
-                auto it = buckets.find(neighborKey);
-                if (it == buckets.end()) continue;
+// Check all active entities for collisions and fire one batched event for the
+// contacts that entered, stayed or exited
+void CollisionSystem::CheckCollisions(const EntityWorld& world, float dt) {
+    if (!broadPhase) {
+        broadPhase = CreateBroadPhase(Config::GetString("collision.broad_phase", "grid"),
+                                      Config::GetFloat("collision.cell_size", 2.0f));
+    }
+    ++frame;
+    time += dt;
 
-                const std::vector<size_t>& a = entry.second;
-                const std::vector<size_t>& b = it->second;
+    bounds.clear();
+    handles.clear();
+    colliders.ForEachBlock(world, [this](size_t count, const EntityHandle* h, const Bounds* b) {
+        bounds.insert(bounds.end(), b, b + count);
+        handles.insert(handles.end(), h, h + count);
+    });
 
-                for (size_t ia = 0; ia < a.size(); ++ia) {
-                    for (size_t ib = 0; ib < b.size(); ++ib) {
-                        size_t i = a[ia];
-                        size_t j = b[ib];
-                        if (i >= j) continue; // avoid duplicate checks and self
-                        if (!entities[i].is_active || !entities[j].is_active) continue;
-                        if (CheckCollisionBoxes(entities[i].bounds, entities[j].bounds)) {
-                            // Build a symmetric pair key (min<<32 | max)
-                            uint32_t a = static_cast<uint32_t>(entities[i].id);
-                            uint32_t b = static_cast<uint32_t>(entities[j].id);
-                            uint32_t lo = (a < b) ? a : b;
-                            uint32_t hi = (a < b) ? b : a;
-                            uint64_t pairKey = (static_cast<uint64_t>(lo) << 32) | hi;
-                            currentFramePairs.insert(pairKey);
+    // Narrow phase per chunk. The split depends only on the work, and the
+    // merged keys are sorted, so the result doesn't depend on the threads.
+    const size_t items = broadPhase->Prepare(bounds);
+    const size_t chunkCount = std::min(MAX_CHUNKS, (items + ITEMS_PER_CHUNK - 1) / ITEMS_PER_CHUNK);
+    if (chunks.size() < chunkCount) chunks.resize(chunkCount);
+    ThreadPool::GetInstance().ParallelFor(chunkCount, [this, items, chunkCount](size_t c) {
+        Chunk& chunk = chunks[c];
+        chunk.pairs.clear();
+        chunk.overlapping.clear();
+        broadPhase->CollectPairs(items * c / chunkCount, items * (c + 1) / chunkCount, chunk.pairs);
+        for (const BroadPhasePair& pair : chunk.pairs) {
+            if (CheckCollisionBoxes(bounds[pair.a], bounds[pair.b]))
+                chunk.overlapping.push_back(PairKey(handles[pair.a].value, handles[pair.b].value));
+        }
+    });
+    overlapping.clear();
+    for (size_t c = 0; c < chunkCount; ++c)
+        overlapping.insert(overlapping.end(), chunks[c].overlapping.begin(), chunks[c].overlapping.end());
+    std::sort(overlapping.begin(), overlapping.end());
 
-                            // Only fire event if this pair was not colliding last frame
-                            if (activePairs.find(pairKey) == activePairs.end()) {
-                                CollisionEvent event;
-                                event.entityA = &entities[i];
-                                event.entityB = &entities[j];
-                                EventManager::GetInstance().FireEvent(event);
-                                activePairs.insert(pairKey);
-                            }
-                        }
-                    }
-                }
-            }
+    // Stamp the contacts that still overlap; collect the ones that are new
+    entered.clear();
+    stayed.clear();
+    exited.clear();
+    fresh.clear();
+    for (uint64_t key : overlapping) {
+        auto it = std::lower_bound(contacts.begin(), contacts.end(), key,
+                                   [](const Contact& c, uint64_t k) { return c.key < k; });
+        if (it == contacts.end() || it->key != key) {
+            fresh.push_back(key);
+            continue;
+        }
+        it->lastSeen = frame;
+        if (time >= it->nextStay) {
+            stayed.push_back(PairOf(key));
+            it->nextStay = time + it->interval;
         }
     }
 
-    // Remove pairs that are no longer colliding
-    for (auto it = activePairs.begin(); it != activePairs.end(); ) {
-        if (currentFramePairs.find(*it) == currentFramePairs.end()) {
-            it = activePairs.erase(it);
-        } else {
-            ++it;
+    // Drop the contacts that weren't stamped, keeping the rest in order
+    size_t kept = 0;
+    for (const Contact& c : contacts) {
+        if (c.lastSeen != frame) exited.push_back(PairOf(c.key));
+        else contacts[kept++] = c;
+    }
+    contacts.resize(kept);
+
+    // Merge the new contacts in from the back, so the table stays sorted in place
+    if (!fresh.empty()) {
+        size_t i = contacts.size();
+        size_t j = fresh.size();
+        contacts.resize(contacts.size() + fresh.size());
+        for (size_t out = contacts.size(); j > 0;) {
+            if (i > 0 && contacts[i - 1].key > fresh[j - 1]) {
+                contacts[--out] = contacts[--i];
+                continue;
+            }
+            const uint64_t key = fresh[--j];
+            const float interval = StayInterval(world, key);
+            const double next = interval >= 0.0f ? time + interval : std::numeric_limits<double>::infinity();
+            contacts[--out] = Contact{ key, frame, interval, next };
         }
+        for (uint64_t key : fresh) entered.push_back(PairOf(key));
     }
+
+    if (entered.empty() && stayed.empty() && exited.empty()) return;
+    CollisionEvent event;
+    event.entered = entered;
+    event.stayed = stayed;
+    event.exited = exited;
+    EventManager::GetInstance().FireEvent(event);
 }
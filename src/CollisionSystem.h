@@ -1,9 +1,61 @@
 #pragma once
-#include <vector>
+#include "BroadPhase.h"
 #include "Entity.h"
+#include "Event.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
-// Detecting interactions between entities
+// Detecting interactions between entities. Contacts persist across checks, so
+// each one is reported as entered once, then as stayed at most every
+// collision.stay_interval seconds (set per pair of archetypes), then as exited.
+// Pair finding and the exact tests run on the thread pool; events come out in
+// pair order, the same for any number of threads.
 class CollisionSystem {
 public:
-    void CheckCollisions(std::vector<Entity>& entities);
+    void CheckCollisions(const EntityWorld& world, float dt);
+    // Replace the broad phase (by default made from collision.broad_phase on first check)
+    void SetBroadPhase(std::unique_ptr<BroadPhase> phase) { broadPhase = std::move(phase); }
+    // Seconds between stay events for contacts between these two archetypes
+    // (0 = every check, negative = never). Applies to contacts entered afterwards.
+    void SetStayInterval(ArchetypeId a, ArchetypeId b, float seconds);
+    // Forget every contact without reporting exits (the world was reset)
+    void ClearContacts();
+    size_t GetContactCount() const { return contacts.size(); }
+
+private:
+    struct Contact {
+        uint64_t key;      // lower handle value << 32 | higher
+        uint32_t lastSeen; // frame the pair last overlapped
+        float interval;    // seconds between stay events, negative for none
+        double nextStay;   // time the next stay event is due
+    };
+
+    float StayInterval(const EntityWorld& world, uint64_t key);
+
+    Query<const Bounds> colliders;
+    std::unique_ptr<BroadPhase> broadPhase;
+    // Every collider's box and handle, gathered from the blocks each check
+    std::vector<BoundingBox> bounds;
+    std::vector<EntityHandle> handles;
+    // Broad phase work is split into chunks run on the thread pool; each chunk
+    // keeps its candidates and the keys of those that really overlap
+    struct Chunk {
+        std::vector<BroadPhasePair> pairs;
+        std::vector<uint64_t> overlapping;
+    };
+    std::vector<Chunk> chunks;
+    std::vector<uint64_t> overlapping; // all chunks' keys, sorted
+
+    std::vector<Contact> contacts; // sorted by key
+    std::vector<uint64_t> fresh;   // pairs first seen this frame
+    uint32_t frame = 0;
+    double time = 0.0;
+    // Stay interval per archetype pair (lower id << 32 | higher), filled on first contact
+    std::unordered_map<uint64_t, float> stayIntervals;
+
+    // Batched event contents, reused every frame
+    std::vector<ContactPair> entered;
+    std::vector<ContactPair> stayed;
+    std::vector<ContactPair> exited;
 };
@@ -0,0 +1,42 @@
+#include "ColumnCache.h"
+
+std::shared_ptr<const ColumnData> ColumnCache::GetOrBuild(int cx, int cz, const Builder& build) {
+    std::shared_ptr<Entry> entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& slot = entries[Key(cx, cz)];
+        if (!slot) slot = std::make_shared<Entry>();
+        entry = slot;
+    }
+
+    // Build outside the map lock; concurrent callers for the same column wait here
+    bool builtHere = false;
+    std::call_once(entry->built, [&] {
+        build(cx, cz, entry->data);
+        builtHere = true;
+    });
+    (builtHere ? misses : hits).fetch_add(1, std::memory_order_relaxed);
+
+    return std::shared_ptr<const ColumnData>(entry, &entry->data);
+}
+
+void ColumnCache::EvictOutside(int cx, int cz, int radius) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = entries.begin(); it != entries.end();) {
+        int x = static_cast<int32_t>(static_cast<uint32_t>(it->first >> 32));
+        int z = static_cast<int32_t>(static_cast<uint32_t>(it->first));
+        int dx = x - cx, dz = z - cz;
+        if (dx * dx + dz * dz > radius * radius) it = entries.erase(it);
+        else ++it;
+    }
+}
+
+void ColumnCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+}
+
+size_t ColumnCache::Size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
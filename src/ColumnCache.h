@@ -0,0 +1,52 @@
+#pragma once
+#include "Blocks.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Per-column (XZ) data shared by every chunk stacked in Y. Index lx + lz * size.
+struct ColumnData {
+    int size = 0;
+    std::vector<int> heights;      // highest solid world y
+    std::vector<uint8_t> biomes;   // biome id
+    std::vector<BlockId> surface;  // top block
+    int minHeight = 0;
+    int maxHeight = 0;
+};
+
+// Thread-safe cache of ColumnData keyed by chunk XZ. Each column is built
+// exactly once even when several generator jobs ask for it at the same time;
+// callers keep their entry alive after it is evicted.
+class ColumnCache {
+public:
+    using Builder = std::function<void(int cx, int cz, ColumnData& out)>;
+
+    std::shared_ptr<const ColumnData> GetOrBuild(int cx, int cz, const Builder& build);
+
+    // Drop columns farther than radius (in chunks, XZ distance) from (cx, cz)
+    void EvictOutside(int cx, int cz, int radius);
+    void Clear();
+
+    size_t Size() const;
+    uint64_t GetHits() const { return hits.load(std::memory_order_relaxed); }
+    uint64_t GetMisses() const { return misses.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        std::once_flag built;
+        ColumnData data;
+    };
+
+    static uint64_t Key(int cx, int cz) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cz);
+    }
+
+    mutable std::mutex mutex;
+    std::unordered_map<uint64_t, std::shared_ptr<Entry>> entries;
+    std::atomic<uint64_t> hits{ 0 };
+    std::atomic<uint64_t> misses{ 0 };
+};
@@ -19,7 +19,7 @@ bool DebugHud::Visible() { return g_visible; }
 
 void DebugHud::Draw(int entities, const char* extra) {
     if (!g_visible) return;
-    char buf[512];
+    char buf[640];
     int len = std::snprintf(buf, sizeof(buf), "Entities: %d\n", entities);
     if (extra != nullptr && extra[0] != '\0' && len < static_cast<int>(sizeof(buf) - 1)) {
         int more = std::snprintf(buf + len, sizeof(buf) - len, "%s\n", extra);
@@ -1,17 +1,48 @@
 #pragma once
 #include "include/raylib.h"
-#include <string>
+#include "Archetype.h"
+#include "EntityWorld.h"
 
-// The base object for everything in the game world
-struct Entity {
-    unsigned int id = 0;
-    bool is_active = false;
-    bool needs_to_die = false;
-    std::string tag;
+// Interned tag string (see EntityManager::InternTag); 0 == untagged
+using TagId = uint32_t;
 
-    Vector3 position = {};
-    Vector3 velocity = {}; 
-    BoundingBox bounds = {};
-    Model model;
+// Half the side of an entity's bounding cube
+constexpr float ENTITY_HALF_EXTENT = 0.5f;
+
+// Built-in entity components. They are plain data stored by EntityWorld in
+// per-component columns; an entity only carries the ones it needs (a static
+// prop has no Velocity, so physics never visits it).
+struct Position : Vector3 {};
+struct Velocity : Vector3 {};
+// World-space box, rebuilt from Position by PhysicsSystem each update
+struct Bounds : BoundingBox {};
+struct Renderable {
+    uint32_t model = 0; // index into EntityManager's model table
     Color color = WHITE;
-};
\ No newline at end of file
+};
+struct Tag {
+    TagId id = 0;
+    uint32_t member = 0; // position in EntityManager's member list for id
+};
+// Archetype an entity was spawned from, so archetype reloads can patch it
+struct Spawned {
+    ArchetypeId archetype = INVALID_ARCHETYPE;
+    uint32_t member = 0; // position in EntityManager's spawn list for archetype
+};
+
+// Moving entity that stops against solid terrain blocks (see PhysicsSystem).
+// Remembers the chunk it was last in as a ChunkStore::Ref, which goes stale
+// only when that chunk is unloaded or moved in the store.
+struct TerrainCollider {
+    uint32_t chunkIndex = 0;
+    uint64_t chunkSerial = 0; // 0 never matches
+    int cx = 0, cy = 0, cz = 0;
+};
+
+// Physics treats runs of positions and velocities as flat float arrays
+static_assert(sizeof(Position) == 3 * sizeof(float) && sizeof(Velocity) == 3 * sizeof(float));
+
+inline Bounds BoundsAround(Vector3 p) {
+    return Bounds{ { { p.x - ENTITY_HALF_EXTENT, p.y - ENTITY_HALF_EXTENT, p.z - ENTITY_HALF_EXTENT },
+                     { p.x + ENTITY_HALF_EXTENT, p.y + ENTITY_HALF_EXTENT, p.z + ENTITY_HALF_EXTENT } } };
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+
+// 32-bit entity reference: pool slot index plus the slot's generation. A slot's
+// generation is bumped every time its entity is destroyed, so handles kept by
+// events or systems stop resolving once the entity is gone instead of silently
+// pointing at whatever reused the slot. Value 0 is never a live entity.
+struct EntityHandle {
+    static constexpr uint32_t INDEX_BITS = 22; // ~4M slots
+    static constexpr uint32_t GENERATION_BITS = 32 - INDEX_BITS;
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static constexpr uint32_t MAX_GENERATION = (1u << GENERATION_BITS) - 1;
+
+    uint32_t value = 0;
+
+    static EntityHandle Make(uint32_t index, uint32_t generation) {
+        return EntityHandle{ (generation << INDEX_BITS) | (index & INDEX_MASK) };
+    }
+
+    uint32_t Index() const { return value & INDEX_MASK; }
+    uint32_t Generation() const { return value >> INDEX_BITS; }
+    bool IsNull() const { return value == 0; }
+    explicit operator bool() const { return value != 0; }
+
+    bool operator==(const EntityHandle& o) const { return value == o.value; }
+    bool operator!=(const EntityHandle& o) const { return value != o.value; }
+    bool operator<(const EntityHandle& o) const { return value < o.value; }
+};
+
+template <>
+struct std::hash<EntityHandle> {
+    size_t operator()(const EntityHandle& h) const noexcept { return std::hash<uint32_t>()(h.value); }
+};
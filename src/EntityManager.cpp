@@ -1,7 +1,9 @@
 #include "EntityManager.h"
 #include "ArchetypeManager.h"
 #include "AssetManager.h"
+#include "Config.h"
 #include "Log.h"
+#include <algorithm>
 
 EntityManager& EntityManager::GetInstance() {
     static EntityManager instance;
@@ -10,104 +12,307 @@ EntityManager& EntityManager::GetInstance() {
 
 // Prepare the entity pool for use
 void EntityManager::Init() {
-    entity_pool.resize(MAX_ENTITIES);
-}
-
-// Find an inactive entity, activate it and return a pointer
-Entity* EntityManager::CreateEntity() {
-    for (int i = 0; i < MAX_ENTITIES; ++i) {
-        if (!entity_pool[i].is_active) {
-            // Reset the entity to a clean state before use
-            entity_pool[i] = Entity();
-            entity_pool[i].is_active = true;
-            entity_pool[i].id = i;
-            ++active_count;
-            return &entity_pool[i];
-        }
-    }
-    return nullptr; // No inactive entities found
+    world.Clear();
+    dying.clear();
+    collisionSystem.ClearContacts();
+    budget = static_cast<size_t>(std::max(0, Config::GetInt("entities.budget", 0)));
+    budgetWarned = false;
+    terrainCollision = Config::GetBool("physics.terrain_collision", true);
+
+    tag_names.assign(1, std::string());
+    tag_ids.clear();
+    tag_members.assign(1, std::vector<EntityHandle>());
+    models.clear();
+    model_ids.clear();
+    spawn_info.clear();
+    spawn_members.clear();
+    patch_queue.clear();
+    patch_head = 0;
 }
 
-// Find a single, active entity by its unique ID
-Entity* EntityManager::FindEntityByID(unsigned int id) {
-    if (id < entity_pool.size() && entity_pool[id].is_active) {
-        return &entity_pool[id];
+size_t EntityManager::Room(size_t wanted) {
+    const size_t live = world.Count();
+    if (budget == 0 || live + wanted <= budget) {
+        budgetWarned = false;
+        return wanted;
+    }
+    if (!budgetWarned) {
+        Log::Warning("EntityManager: entity budget of " + std::to_string(budget) + " reached; not spawning more");
+        budgetWarned = true;
     }
-    return nullptr; // Return null if ID is out of bounds or entity is not active
+    return live < budget ? budget - live : 0;
+}
+
+EntityHandle EntityManager::CreateEntity() {
+    if (Room(1) == 0) return EntityHandle{};
+    return world.Create<Position>(Position{});
+}
+
+void EntityManager::DestroyEntity(EntityHandle id) {
+    // Queued twice is harmless: the second Destroy finds the handle dead
+    if (world.IsAlive(id)) dying.push_back(id);
+}
+
+Color* EntityManager::GetColor(EntityHandle id) {
+    Renderable* r = world.Get<Renderable>(id);
+    return r ? &r->color : nullptr;
+}
+
+TagId EntityManager::GetTag(EntityHandle id) const {
+    const Tag* t = world.Get<Tag>(id);
+    return t ? t->id : 0;
+}
+
+TagId EntityManager::InternTag(const std::string& tag) {
+    if (tag.empty()) return 0;
+    auto it = tag_ids.find(tag);
+    if (it != tag_ids.end()) return it->second;
+    TagId id = static_cast<TagId>(tag_names.size());
+    tag_names.push_back(tag);
+    tag_ids.emplace(tag, id);
+    tag_members.emplace_back();
+    return id;
+}
+
+const std::string& EntityManager::GetTagName(TagId tag) const {
+    return tag < tag_names.size() ? tag_names[tag] : tag_names[0];
 }
 
 // Find all active entities that have a specific tag
-std::vector<Entity*> EntityManager::FindEntitiesWithTag(const std::string& tag) {
-    std::vector<Entity*> tagged_entities;
-    for (auto& entity : entity_pool) {
-        if (entity.is_active && entity.tag == tag) {
-            tagged_entities.push_back(&entity);
+std::span<const EntityHandle> EntityManager::FindEntitiesWithTag(TagId tag) const {
+    if (tag == 0 || tag >= tag_members.size()) return {};
+    return tag_members[tag];
+}
+
+std::span<const EntityHandle> EntityManager::FindEntitiesWithTag(const std::string& tag) const {
+    auto it = tag_ids.find(tag);
+    if (it == tag_ids.end()) return {};
+    return FindEntitiesWithTag(it->second);
+}
+
+void EntityManager::IndexTag(EntityHandle id, Tag& tag) {
+    std::vector<EntityHandle>& members = tag_members[tag.id];
+    tag.member = static_cast<uint32_t>(members.size());
+    members.push_back(id);
+}
+
+// Swap-remove from the member list; the entity moved into the hole learns its new position
+void EntityManager::UnindexTag(const Tag& tag) {
+    std::vector<EntityHandle>& members = tag_members[tag.id];
+    const EntityHandle last = members.back();
+    members[tag.member] = last;
+    members.pop_back();
+    if (tag.member < members.size()) world.Get<Tag>(last)->member = tag.member;
+}
+
+// Same swap-remove for the per-archetype spawn lists
+void EntityManager::UnindexSpawn(const Spawned& spawned) {
+    std::vector<EntityHandle>& members = spawn_members[spawned.archetype];
+    const EntityHandle last = members.back();
+    members[spawned.member] = last;
+    members.pop_back();
+    if (spawned.member < members.size()) world.Get<Spawned>(last)->member = spawned.member;
+}
+
+void EntityManager::SetTag(EntityHandle id, TagId tag) {
+    if (!world.IsAlive(id) || tag >= tag_members.size()) return;
+    if (Tag* current = world.Get<Tag>(id)) {
+        if (current->id == tag) return;
+        UnindexTag(*current);
+        if (tag == 0) {
+            world.Remove<Tag>(id);
+            return;
         }
+        current->id = tag;
+        IndexTag(id, *current);
+    } else if (tag != 0) {
+        IndexTag(id, *world.Add<Tag>(id, Tag{ tag, 0 }));
     }
-    return tagged_entities;
 }
 
 // Update all core systems and active entities
 void EntityManager::UpdateAll(float dt) {
-    // Run systems that operate on all entities
-    physicsSystem.Update(entity_pool, dt);
-    collisionSystem.CheckCollisions(entity_pool);
-    
-    // Loop for individual entity logic
-    for (auto& entity : entity_pool) {
-        if (entity.is_active) {
-            // Behavior logic will be called here
-        }
+    // Each system iterates just the entities matching its queries
+    physicsSystem.Update(world, dt);
+    collisionSystem.CheckCollisions(world, dt);
+
+    // Remove the entities queued by DestroyEntity during the update
+    for (EntityHandle h : dying) {
+        if (const Tag* tag = world.Get<Tag>(h)) UnindexTag(*tag);
+        if (const Spawned* source = world.Get<Spawned>(h)) UnindexSpawn(*source);
+        world.Destroy(h);
     }
+    dying.clear();
+}
 
-    // A second loop
-    // This deactivates any entities that were marked for death during the update phase
-    for (size_t i = 0; i < entity_pool.size(); ++i) {
-        auto& entity = entity_pool[i];
-        if (entity.is_active && entity.needs_to_die) {
-            entity = Entity();
-            entity.id = static_cast<unsigned int>(i);
-            --active_count;
-        }
+uint32_t EntityManager::InternModel(const std::string& modelId) {
+    auto it = model_ids.find(modelId);
+    if (it != model_ids.end()) return it->second;
+
+    // Paranoid check for the model
+    Model model;
+    if (AssetManager::ModelExists(modelId)) {
+        model = AssetManager::GetModel(modelId);
+    } else {
+        Log::Error("Model '" + modelId + "' not found. Using default thing.");
+        model = AssetManager::GetModel("cube"); // Fallback
     }
+    uint32_t index = static_cast<uint32_t>(models.size());
+    models.push_back(model);
+    model_ids.emplace(modelId, index);
+    return index;
 }
 
-// Function that builds an entity from an archetype
-Entity* EntityManager::CreateEntityFromArchetype(const std::string& name, Vector3 position) {
-    Archetype* arch = ArchetypeManager::GetInstance().GetArchetype(name);
-    if (!arch) {
-        Log::Error("Failed to create entity: Archetype '" + name + "' not found.");
-        return nullptr;
+// Components and values an archetype gives its entities, worked out on first spawn
+const EntityManager::SpawnInfo* EntityManager::ResolveSpawn(ArchetypeId archetype) {
+    if (archetype < spawn_info.size() && spawn_info[archetype].resolved) return &spawn_info[archetype];
+    const Archetype* arch = ArchetypeManager::GetInstance().GetArchetype(archetype);
+    if (!arch) return nullptr;
+    if (archetype >= spawn_info.size()) {
+        spawn_info.resize(archetype + 1);
+        spawn_members.resize(archetype + 1);
     }
 
-    Entity* newEntity = CreateEntity();
-    if (newEntity) {
-        newEntity->position = position;
-        newEntity->tag = arch->tag;
-        newEntity->color = arch->color;
-        newEntity->velocity = arch->velocity;
-
-        // Paranoid check for the model
-        if (AssetManager::ModelExists(arch->model_id)) {
-             newEntity->model = AssetManager::GetModel(arch->model_id);
-        } else {
-            Log::Error("Model '" + arch->model_id + "' not found for archetype '" + name + "'. Using default thing.");
-            newEntity->model = AssetManager::GetModel("cube"); // Fallback
-        }
+    // Only what the archetype uses: entities at rest stay out of the physics
+    // query and untagged ones carry no Tag
+    SpawnInfo& info = spawn_info[archetype];
+    info.moves = arch->velocity.x != 0.0f || arch->velocity.y != 0.0f || arch->velocity.z != 0.0f;
+    info.velocity = Velocity{ arch->velocity };
+    info.tag = InternTag(arch->tag);
+    info.renderable = Renderable{ InternModel(arch->model_id), arch->color };
+    info.mask = ComponentMaskOf<Position, Bounds, Renderable, Spawned>();
+    if (info.moves) info.mask |= ComponentMaskOf<Velocity>();
+    if (info.moves && terrainCollision) info.mask |= ComponentMaskOf<TerrainCollider>();
+    if (info.tag) info.mask |= ComponentMaskOf<Tag>();
+    info.resolved = true;
+    return &info;
+}
+
+size_t EntityManager::SpawnBatch(ArchetypeId archetype, size_t count, std::span<const Vector3> positions,
+                                 std::span<EntityHandle> handles) {
+    const SpawnInfo* info = ResolveSpawn(archetype);
+    if (!info) {
+        Log::Error("Failed to spawn: unknown archetype id " + std::to_string(archetype));
+        return 0;
+    }
+    if (positions.size() < count) {
+        Log::Warning("SpawnBatch: " + std::to_string(positions.size()) + " positions for " + std::to_string(count) + " entities");
+        count = positions.size();
+    }
+    count = Room(count);
+    if (count == 0) return 0;
+
+    EntityHandle* out = handles.data();
+    if (handles.size() < count) {
+        spawn_handles.resize(count);
+        out = spawn_handles.data();
     }
-    return newEntity;
+    std::vector<EntityHandle>* members = info->tag ? &tag_members[info->tag] : nullptr;
+    if (members) members->reserve(members->size() + count);
+    std::vector<EntityHandle>& spawns = spawn_members[archetype];
+    spawns.reserve(spawns.size() + count);
+
+    return world.CreateBatch(info->mask, count, out,
+        [&](EntityTable& table, const EntityBlock& block, uint32_t row, uint32_t rows, size_t first) {
+            const Vector3* p = positions.data() + first;
+            Position* pos = table.Column<Position>(block) + row;
+            Bounds* bounds = table.Column<Bounds>(block) + row;
+            Renderable* render = table.Column<Renderable>(block) + row;
+            Spawned* source = table.Column<Spawned>(block) + row;
+            for (uint32_t i = 0; i < rows; ++i) {
+                pos[i] = Position{ p[i] };
+                bounds[i] = BoundsAround(p[i]);
+                render[i] = info->renderable;
+                source[i] = Spawned{ archetype, static_cast<uint32_t>(spawns.size()) };
+                spawns.push_back(out[first + i]);
+            }
+            if (info->moves) {
+                Velocity* vel = table.Column<Velocity>(block) + row;
+                for (uint32_t i = 0; i < rows; ++i) vel[i] = info->velocity;
+            }
+            if (members) {
+                Tag* tags = table.Column<Tag>(block) + row;
+                for (uint32_t i = 0; i < rows; ++i) {
+                    tags[i] = Tag{ info->tag, static_cast<uint32_t>(members->size()) };
+                    members->push_back(out[first + i]);
+                }
+            }
+        });
+}
+
+namespace {
+    enum : uint8_t { PATCH_RENDER = 1, PATCH_VELOCITY = 2, PATCH_TAG = 4 };
 }
 
+size_t EntityManager::RefreshArchetypes(std::span<const ArchetypeId> archetypes) {
+    const size_t queued = GetQueuedPatches();
+    for (ArchetypeId id : archetypes) {
+        // Nothing spawned from it yet: the next spawn resolves it fresh anyway
+        if (id >= spawn_info.size() || !spawn_info[id].resolved) continue;
+        const SpawnInfo old = spawn_info[id];
+        spawn_info[id].resolved = false;
+        const SpawnInfo* now = ResolveSpawn(id);
+        if (!now) continue;
 
-// RENDERER MUST BE MODIFIED TO USE THE NEW COLOR
-void EntityManager::RenderAll() {
-    for (const auto& entity : entity_pool) {
-        if (entity.is_active) {
-            DrawModel(entity.model, entity.position, 1.0f, entity.color); // Use entity's colour now
+        uint8_t fields = 0;
+        if (old.renderable.model != now->renderable.model ||
+            old.renderable.color.r != now->renderable.color.r || old.renderable.color.g != now->renderable.color.g ||
+            old.renderable.color.b != now->renderable.color.b || old.renderable.color.a != now->renderable.color.a)
+            fields |= PATCH_RENDER;
+        if (old.moves != now->moves || old.velocity.x != now->velocity.x ||
+            old.velocity.y != now->velocity.y || old.velocity.z != now->velocity.z)
+            fields |= PATCH_VELOCITY;
+        if (old.tag != now->tag) fields |= PATCH_TAG;
+        if (fields == 0) continue;
+
+        // Handles, not rows: a velocity or tag change moves entities between
+        // tables, and queued entities may be destroyed before their turn
+        for (EntityHandle h : spawn_members[id]) patch_queue.push_back(ArchetypePatch{ h, fields });
+    }
+    return GetQueuedPatches() - queued;
+}
+
+size_t EntityManager::PatchSpawned(size_t maxEntities) {
+    size_t patched = 0;
+    while (patch_head < patch_queue.size() && (maxEntities == 0 || patched < maxEntities)) {
+        const ArchetypePatch patch = patch_queue[patch_head++];
+        const Spawned* source = world.Get<Spawned>(patch.entity);
+        if (!source) continue;
+        const SpawnInfo& now = spawn_info[source->archetype];
+        const EntityHandle h = patch.entity;
+        if (patch.fields & PATCH_RENDER) *world.Get<Renderable>(h) = now.renderable;
+        if (patch.fields & PATCH_VELOCITY) {
+            if (now.moves) world.Add<Velocity>(h, now.velocity);
+            else world.Remove<Velocity>(h);
+            if (now.moves && terrainCollision && !world.Has<TerrainCollider>(h)) world.Add<TerrainCollider>(h);
+            else if (!now.moves) world.Remove<TerrainCollider>(h);
         }
+        if (patch.fields & PATCH_TAG) SetTag(h, now.tag);
+        ++patched;
+    }
+    if (patch_head == patch_queue.size()) {
+        patch_queue.clear();
+        patch_head = 0;
     }
+    return patched;
+}
+
+// Function that builds an entity from an archetype
+EntityHandle EntityManager::CreateEntityFromArchetype(const std::string& name, Vector3 position) {
+    // FindArchetypeId already warns about unknown names
+    ArchetypeId archetype = ArchetypeManager::GetInstance().FindArchetypeId(name);
+    if (archetype == INVALID_ARCHETYPE) return EntityHandle{};
+    EntityHandle handle;
+    SpawnBatch(archetype, 1, std::span<const Vector3>(&position, 1), std::span<EntityHandle>(&handle, 1));
+    return handle;
+}
+
+void EntityManager::RenderAll() {
+    drawable.ForEach(world, [this](EntityHandle, const Position& p, const Renderable& r) {
+        DrawModel(models[r.model], p, 1.0f, r.color);
+    });
 }
 
 int EntityManager::GetActiveCount() const {
-    return active_count;
+    return static_cast<int>(world.Count());
 }
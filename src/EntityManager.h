@@ -1,32 +1,145 @@
 #pragma once
+#include "Archetype.h"
 #include "Entity.h"
 #include "PhysicsSystem.h"
 #include "CollisionSystem.h"
+#include <span>
+#include <type_traits>
 #include <vector>
 #include <string>
-
-// Maximum number of entities allowed in the world
-constexpr int MAX_ENTITIES = 1000; // CHANGE ME OR I WILL FIND YOU
+#include <unordered_map>
 
 class EntityManager {
 public:
     static EntityManager& GetInstance();
     void Init();
-    Entity* CreateEntity();
-    Entity* CreateEntityFromArchetype(const std::string& name, Vector3 position); // The Factory
+    // Entity with just a Position; give it more with AddComponent.
+    // Null handle when the entity budget is used up.
+    EntityHandle CreateEntity();
+    EntityHandle CreateEntityFromArchetype(const std::string& name, Vector3 position); // The Factory
+    // Spawn count entities of one archetype (id from ArchetypeManager::FindArchetypeId)
+    // at positions[0..count). The archetype and its model are resolved once per id,
+    // and the rows are written block by block. Handles go to `handles` when it has
+    // room for count. Returns how many spawned (the budget may cut a batch short).
+    size_t SpawnBatch(ArchetypeId archetype, size_t count, std::span<const Vector3> positions,
+                      std::span<EntityHandle> handles = {});
+    // Queue an entity for removal at the end of UpdateAll; its handle stops resolving then
+    void DestroyEntity(EntityHandle id);
     void UpdateAll(float dt);
     void RenderAll();
     int GetActiveCount() const;
 
-    Entity* FindEntityByID(unsigned int id);
-    std::vector<Entity*> FindEntitiesWithTag(const std::string& tag);
+    // Optional cap on live entities (entities.budget, 0 = unlimited). Storage
+    // itself grows as needed; the budget only guards against runaway spawning.
+    void SetBudget(size_t budget) { this->budget = budget; }
+    size_t GetBudget() const { return budget; }
+    EntityWorld::Stats GetStats() const { return world.GetStats(); }
+
+    // Row of a live entity in the world, or null (also for destroyed entities
+    // whose slot has been reused). Valid until entities are created, removed
+    // or change components.
+    const EntityWorld::Location* FindEntityByID(EntityHandle id) const { return world.Find(id); }
+    bool IsAlive(EntityHandle id) const { return world.IsAlive(id); }
+    // Live entities with a tag, in no particular order. The view is kept up
+    // to date by create/destroy/SetTag and stays valid until the next of those.
+    std::span<const EntityHandle> FindEntitiesWithTag(TagId tag) const;
+    std::span<const EntityHandle> FindEntitiesWithTag(const std::string& tag) const;
+
+    // Component access by handle; null for dead handles or missing components.
+    // Same lifetime as FindEntityByID.
+    template <class T>
+    T* GetComponent(EntityHandle id) { return world.Get<T>(id); }
+    template <class T>
+    const T* GetComponent(EntityHandle id) const { return world.Get<T>(id); }
+    Vector3* GetPosition(EntityHandle id) { return world.Get<Position>(id); }
+    Vector3* GetVelocity(EntityHandle id) { return world.Get<Velocity>(id); }
+    Color* GetColor(EntityHandle id);
+    TagId GetTag(EntityHandle id) const;
+
+    // Moving an entity to a new component set; not while systems are updating
+    template <class T>
+    T* AddComponent(EntityHandle id, const T& value = T{}) {
+        static_assert(!std::is_same_v<T, Tag>, "use SetTag so the tag index stays current");
+        static_assert(!std::is_same_v<T, Spawned>, "Spawned is set by SpawnBatch and indexed per archetype");
+        return world.Add<T>(id, value);
+    }
+    template <class T>
+    bool RemoveComponent(EntityHandle id) {
+        static_assert(!std::is_same_v<T, Tag>, "use SetTag so the tag index stays current");
+        static_assert(!std::is_same_v<T, Spawned>, "Spawned is set by SpawnBatch and indexed per archetype");
+        return world.Remove<T>(id);
+    }
+    // Retag an entity (0 removes its Tag); same rules as AddComponent
+    void SetTag(EntityHandle id, TagId tag);
+
+    // Apply reloaded archetypes (ArchetypeManager::ReloadFiles) to the entities
+    // spawned from them, in place: only fields whose archetype value changed are
+    // written, so per-entity state like a gameplay-set velocity survives unrelated
+    // edits. The entities are queued; PatchSpawned writes them. Returns the number queued.
+    size_t RefreshArchetypes(std::span<const ArchetypeId> archetypes);
+    // Write up to maxEntities queued archetype patches (0 = all), oldest first.
+    // Returns how many were written. Not while systems are updating.
+    size_t PatchSpawned(size_t maxEntities);
+    size_t GetQueuedPatches() const { return patch_queue.size() - patch_head; }
+
+    // Tag strings are stored once; entities hold the id
+    TagId InternTag(const std::string& tag);
+    const std::string& GetTagName(TagId tag) const;
+
+    const EntityWorld& GetWorld() const { return world; }
+    // Model for a Renderable::model index
+    const Model& GetModel(uint32_t index) const { return models[index]; }
 
 private:
     EntityManager() {}
-    std::vector<Entity> entity_pool;
-    int active_count = 0;
+
+    // Model table entry for an archetype's model id (resolved once, shared by its entities)
+    uint32_t InternModel(const std::string& modelId);
+    // How many of `wanted` new entities fit the budget (warns once each time it fills)
+    size_t Room(size_t wanted);
+
+    struct SpawnInfo {
+        bool resolved = false;
+        bool moves = false;
+        ComponentMask mask = 0;
+        Renderable renderable;
+        Velocity velocity{};
+        TagId tag = 0;
+    };
+    const SpawnInfo* ResolveSpawn(ArchetypeId archetype);
+    // Membership list upkeep for an entity's Tag component
+    void IndexTag(EntityHandle id, Tag& tag);
+    void UnindexTag(const Tag& tag);
+    void UnindexSpawn(const Spawned& spawned);
+
+    EntityWorld world;
+    std::vector<EntityHandle> dying; // queued by DestroyEntity
+    size_t budget = 0;
+    bool budgetWarned = false;
+    bool terrainCollision = true; // physics.terrain_collision: moving spawns get a TerrainCollider
+
+    std::vector<std::string> tag_names; // TagId -> string; [0] is the empty tag
+    std::unordered_map<std::string, TagId> tag_ids;
+    // TagId -> live entities with that tag; Tag::member is the position in it
+    std::vector<std::vector<EntityHandle>> tag_members;
+    std::vector<Model> models;
+    std::unordered_map<std::string, uint32_t> model_ids;
+    std::vector<SpawnInfo> spawn_info;        // by ArchetypeId
+    // ArchetypeId -> live entities spawned from it; Spawned::member is the position in it
+    std::vector<std::vector<EntityHandle>> spawn_members;
+    std::vector<EntityHandle> spawn_handles;  // SpawnBatch output when the caller passes none
+
+    Query<const Position, const Renderable> drawable;
+    // Archetype reload work queued by RefreshArchetypes: each entry writes the
+    // given fields from the archetype's current SpawnInfo
+    struct ArchetypePatch {
+        EntityHandle entity;
+        uint8_t fields = 0;
+    };
+    std::vector<ArchetypePatch> patch_queue;
+    size_t patch_head = 0;
 
     // Instances of the core gameplay systems
     PhysicsSystem physicsSystem;
     CollisionSystem collisionSystem;
-};
\ No newline at end of file
+};
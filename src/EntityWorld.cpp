@@ -0,0 +1,331 @@
+#include "EntityWorld.h"
+#include "Log.h"
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string>
+
+namespace {
+    constexpr std::align_val_t BLOCK_ALIGN{ 64 };
+
+    struct ComponentInfo {
+        size_t size;
+        size_t align;
+    };
+
+    std::mutex g_registryMutex;
+    std::vector<ComponentInfo> g_components;
+
+    size_t AlignUp(size_t value, size_t align) {
+        return (value + align - 1) / align * align;
+    }
+}
+
+ComponentId ComponentRegistry::Register(size_t size, size_t align) {
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    if (g_components.size() >= MAX_COMPONENT_TYPES) {
+        Log::Error("ComponentRegistry: more than " + std::to_string(MAX_COMPONENT_TYPES) + " component types");
+        return MAX_COMPONENT_TYPES - 1;
+    }
+    g_components.push_back(ComponentInfo{ size, align });
+    return static_cast<ComponentId>(g_components.size() - 1);
+}
+
+size_t ComponentRegistry::GetSize(ComponentId id) {
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    return g_components[id].size;
+}
+
+size_t ComponentRegistry::GetAlign(ComponentId id) {
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    return g_components[id].align;
+}
+
+// ---------------------------------------------------------------------------
+
+EntityTable::EntityTable(ComponentMask mask) : mask(mask) {
+    size_t rowBytes = sizeof(EntityHandle);
+    for (ComponentId id = 0; id < MAX_COMPONENT_TYPES; ++id) {
+        if (!Has(id)) continue;
+        ids.push_back(id);
+        sizes[id] = static_cast<uint32_t>(ComponentRegistry::GetSize(id));
+        rowBytes += sizes[id];
+    }
+
+    // Columns follow each other in the block, each aligned for its type. Start
+    // from the unpadded row count and back off until the padding fits too.
+    size_t rows = ENTITY_BLOCK_BYTES / rowBytes;
+    for (; rows > 1; --rows) {
+        size_t offset = AlignUp(rows * sizeof(EntityHandle), alignof(std::max_align_t));
+        for (ComponentId id : ids) {
+            offset = AlignUp(offset, ComponentRegistry::GetAlign(id));
+            offset += rows * sizes[id];
+        }
+        if (offset <= ENTITY_BLOCK_BYTES) break;
+    }
+    capacity = static_cast<uint32_t>(rows);
+
+    handleOffset = 0;
+    size_t offset = AlignUp(capacity * sizeof(EntityHandle), alignof(std::max_align_t));
+    for (ComponentId id : ids) {
+        offset = AlignUp(offset, ComponentRegistry::GetAlign(id));
+        offsets[id] = static_cast<uint32_t>(offset);
+        offset += capacity * sizes[id];
+    }
+}
+
+EntityTable::~EntityTable() {
+    Clear();
+}
+
+void EntityTable::FreeBlock(std::byte* data) {
+    ::operator delete(data, BLOCK_ALIGN);
+}
+
+void EntityTable::Append(EntityHandle handle, uint32_t& block, uint32_t& row) {
+    if (blocks.empty() || blocks.back().count == capacity) {
+        std::byte* data = spare ? spare : static_cast<std::byte*>(::operator new(ENTITY_BLOCK_BYTES, BLOCK_ALIGN));
+        spare = nullptr;
+        blocks.push_back(EntityBlock{ data, 0 });
+    }
+
+    EntityBlock& last = blocks.back();
+    block = static_cast<uint32_t>(blocks.size() - 1);
+    row = last.count++;
+    ++count;
+
+    Handles(last)[row] = handle;
+    for (ComponentId id : ids) {
+        const size_t size = sizes[id];
+        std::memset(static_cast<std::byte*>(Column(last, id)) + row * size, 0, size);
+    }
+}
+
+void EntityTable::AppendBatch(const EntityHandle* handles, size_t n, uint32_t& block, uint32_t& row) {
+    block = static_cast<uint32_t>(blocks.size());
+    row = 0;
+    if (!blocks.empty() && blocks.back().count < capacity) {
+        block = static_cast<uint32_t>(blocks.size() - 1);
+        row = blocks.back().count;
+    }
+
+    for (size_t done = 0; done < n;) {
+        if (blocks.empty() || blocks.back().count == capacity) {
+            std::byte* data = spare ? spare : static_cast<std::byte*>(::operator new(ENTITY_BLOCK_BYTES, BLOCK_ALIGN));
+            spare = nullptr;
+            blocks.push_back(EntityBlock{ data, 0 });
+        }
+        EntityBlock& last = blocks.back();
+        const uint32_t first = last.count;
+        const uint32_t rows = static_cast<uint32_t>(std::min<size_t>(capacity - first, n - done));
+        std::memcpy(Handles(last) + first, handles + done, rows * sizeof(EntityHandle));
+        for (ComponentId id : ids) {
+            std::memset(static_cast<std::byte*>(Column(last, id)) + first * sizes[id], 0, rows * sizes[id]);
+        }
+        last.count += rows;
+        done += rows;
+    }
+    count += n;
+}
+
+EntityHandle EntityTable::Remove(uint32_t block, uint32_t row) {
+    const uint32_t lastBlock = static_cast<uint32_t>(blocks.size() - 1);
+    EntityBlock& tail = blocks[lastBlock];
+    const uint32_t lastRow = tail.count - 1;
+
+    EntityHandle moved{};
+    if (block != lastBlock || row != lastRow) {
+        const EntityBlock& hole = blocks[block];
+        moved = Handles(tail)[lastRow];
+        Handles(hole)[row] = moved;
+        for (ComponentId id : ids) {
+            const size_t size = sizes[id];
+            std::memcpy(static_cast<std::byte*>(Column(hole, id)) + row * size,
+                        static_cast<const std::byte*>(Column(tail, id)) + lastRow * size, size);
+        }
+    }
+
+    --count;
+    if (--tail.count == 0) {
+        // Keep one empty block around so an entity hovering at a block
+        // boundary doesn't allocate and free every time it moves
+        if (spare) FreeBlock(spare);
+        spare = tail.data;
+        blocks.pop_back();
+    }
+    return moved;
+}
+
+void EntityTable::Clear() {
+    for (EntityBlock& block : blocks) FreeBlock(block.data);
+    blocks.clear();
+    if (spare) FreeBlock(spare);
+    spare = nullptr;
+    count = 0;
+}
+
+void EntityTable::CopyShared(const EntityTable& src, uint32_t srcBlock, uint32_t srcRow,
+                             EntityTable& dst, uint32_t dstBlock, uint32_t dstRow) {
+    const EntityBlock& from = src.blocks[srcBlock];
+    const EntityBlock& to = dst.blocks[dstBlock];
+    for (ComponentId id : src.ids) {
+        if (!dst.Has(id)) continue;
+        const size_t size = src.sizes[id];
+        std::memcpy(static_cast<std::byte*>(dst.Column(to, id)) + dstRow * size,
+                    static_cast<const std::byte*>(src.Column(from, id)) + srcRow * size, size);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+EntityTable& EntityWorld::TableFor(ComponentMask mask) {
+    auto it = tableByMask.find(mask);
+    if (it != tableByMask.end()) return *it->second;
+
+    tables.push_back(std::make_unique<EntityTable>(mask));
+    EntityTable* table = tables.back().get();
+    tableByMask.emplace(mask, table);
+    return *table;
+}
+
+uint32_t EntityWorld::AllocateSlot() {
+    if (!freeSlots.empty()) {
+        uint32_t i = freeSlots.back();
+        freeSlots.pop_back();
+        return i;
+    }
+    // Handles carry INDEX_BITS of slot index, the only hard limit left
+    if (slotCount > EntityHandle::INDEX_MASK) {
+        Log::Error("EntityWorld: out of entity slots");
+        return UINT32_MAX;
+    }
+    const uint32_t i = slotCount++;
+    if (i / ENTITY_SLOT_PAGE_SIZE == slotPages.size()) {
+        slotPages.push_back(std::make_unique<Slot[]>(ENTITY_SLOT_PAGE_SIZE));
+    }
+    return i;
+}
+
+EntityHandle EntityWorld::Create(ComponentMask mask) {
+    const uint32_t i = AllocateSlot();
+    if (i == UINT32_MAX) return EntityHandle{};
+
+    Slot& slot = SlotAt(i);
+    EntityHandle handle = EntityHandle::Make(i, slot.generation);
+    EntityTable& table = TableFor(mask);
+    slot.loc.table = &table;
+    table.Append(handle, slot.loc.block, slot.loc.row);
+    slot.alive = true;
+    if (++live > peak) peak = live;
+    return handle;
+}
+
+size_t EntityWorld::CreateBatch(ComponentMask mask, size_t count, EntityHandle* handles, Location& first) {
+    EntityTable& table = TableFor(mask);
+    size_t created = 0;
+    for (; created < count; ++created) {
+        const uint32_t i = AllocateSlot();
+        if (i == UINT32_MAX) break;
+        handles[created] = EntityHandle::Make(i, SlotAt(i).generation);
+    }
+
+    first = Location{ &table, 0, 0 };
+    table.AppendBatch(handles, created, first.block, first.row);
+
+    // Slot locations follow the rows
+    const uint32_t capacity = table.GetBlockCapacity();
+    uint32_t block = first.block;
+    uint32_t row = first.row;
+    for (size_t n = 0; n < created; ++n) {
+        Slot& slot = SlotAt(handles[n].Index());
+        slot.loc = Location{ &table, block, row };
+        slot.alive = true;
+        if (++row == capacity) {
+            row = 0;
+            ++block;
+        }
+    }
+
+    live += created;
+    if (live > peak) peak = live;
+    return created;
+}
+
+void EntityWorld::Destroy(EntityHandle handle) {
+    if (!Find(handle)) return;
+    const uint32_t i = handle.Index();
+    Slot& slot = SlotAt(i);
+
+    EntityHandle moved = slot.loc.table->Remove(slot.loc.block, slot.loc.row);
+    if (moved) SlotAt(moved.Index()).loc = slot.loc;
+
+    --live;
+    ReleaseSlot(i);
+}
+
+void EntityWorld::ReleaseSlot(uint32_t i) {
+    Slot& slot = SlotAt(i);
+    slot.loc = Location{};
+    slot.alive = false;
+    // Bump the generation so outstanding handles stop resolving. A slot whose
+    // generation would wrap is retired rather than risk matching an old handle.
+    if (slot.generation < EntityHandle::MAX_GENERATION) {
+        ++slot.generation;
+        freeSlots.push_back(i);
+    } else {
+        Log::Debug("EntityWorld: retiring slot " + std::to_string(i) + " after exhausting its generations");
+    }
+}
+
+void EntityWorld::Clear() {
+    for (auto& table : tables) table->Clear();
+    // Free and retired slots stay as they are; live ones are released like Destroy does
+    for (uint32_t i = 0; i < slotCount; ++i) {
+        if (SlotAt(i).alive) ReleaseSlot(i);
+    }
+    live = 0;
+    peak = 0;
+}
+
+const EntityWorld::Location* EntityWorld::Find(EntityHandle handle) const {
+    const uint32_t i = handle.Index();
+    if (i < slotCount) {
+        const Slot& slot = SlotAt(i);
+        if (slot.alive && slot.generation == handle.Generation()) return &slot.loc;
+    }
+    return nullptr;
+}
+
+ComponentMask EntityWorld::GetMask(EntityHandle handle) const {
+    const Location* loc = Find(handle);
+    return loc ? loc->table->GetMask() : 0;
+}
+
+// Re-home an entity in the table for a new component set, keeping the values
+// of the components it still has
+bool EntityWorld::Move(EntityHandle handle, ComponentMask mask) {
+    if (!Find(handle)) return false;
+    Slot& slot = SlotAt(handle.Index());
+    EntityTable& src = *slot.loc.table;
+    if (src.GetMask() == mask) return true;
+
+    EntityTable& dst = TableFor(mask);
+    Location to{ &dst, 0, 0 };
+    dst.Append(handle, to.block, to.row);
+    EntityTable::CopyShared(src, slot.loc.block, slot.loc.row, dst, to.block, to.row);
+
+    EntityHandle moved = src.Remove(slot.loc.block, slot.loc.row);
+    if (moved) SlotAt(moved.Index()).loc = slot.loc;
+    slot.loc = to;
+    return true;
+}
+
+EntityWorld::Stats EntityWorld::GetStats() const {
+    Stats stats;
+    stats.live = live;
+    stats.peak = peak;
+    stats.slots = slotCount;
+    for (const auto& table : tables) stats.blocks += table->GetAllocatedBlocks();
+    stats.bytes = stats.blocks * ENTITY_BLOCK_BYTES + slotPages.size() * ENTITY_SLOT_PAGE_SIZE * sizeof(Slot);
+    return stats;
+}
@@ -0,0 +1,320 @@
+#pragma once
+#include "EntityHandle.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Archetype-chunked entity storage. Every distinct set of components an entity
+// can have gets an EntityTable, and a table keeps its entities in fixed-size
+// EntityBlocks: one allocation holding a packed column per component plus the
+// entities' handles. A Query visits the tables whose set includes its
+// components and hands systems whole columns, so an update is a few linear
+// loops per block. Adding or removing a component moves the entity's row into
+// the table for its new set.
+//
+// (These component-set tables are unrelated to the data-file Archetype
+// templates in ArchetypeManager, which only supply a spawned entity's values.)
+
+using ComponentId = uint32_t;
+using ComponentMask = uint64_t; // bit i set == has component id i
+constexpr ComponentId MAX_COMPONENT_TYPES = 64;
+
+// Bytes per EntityBlock; the row capacity of a table follows from its components
+constexpr size_t ENTITY_BLOCK_BYTES = 16 * 1024;
+// Handle slots are allocated this many at a time and never move
+constexpr uint32_t ENTITY_SLOT_PAGE_SIZE = 4096;
+
+namespace ComponentRegistry {
+    // Assign the next component id (ComponentTypeId does this once per type)
+    ComponentId Register(size_t size, size_t align);
+    size_t GetSize(ComponentId id);
+    size_t GetAlign(ComponentId id);
+}
+
+// Id of component type T, assigned on first use. Components are plain data:
+// rows move between blocks by memcpy and new rows start zeroed.
+template <class T>
+ComponentId ComponentTypeId() {
+    if constexpr (!std::is_same_v<T, std::remove_cv_t<T>>) {
+        return ComponentTypeId<std::remove_cv_t<T>>(); // const Velocity is Velocity
+    } else {
+        static_assert(std::is_trivially_copyable_v<T>, "components must be trivially copyable");
+        static const ComponentId id = ComponentRegistry::Register(sizeof(T), alignof(T));
+        return id;
+    }
+}
+
+template <class... Ts>
+ComponentMask ComponentMaskOf() {
+    return (ComponentMask{ 0 } | ... | (ComponentMask{ 1 } << ComponentTypeId<Ts>()));
+}
+
+struct EntityBlock {
+    std::byte* data = nullptr;
+    uint32_t count = 0; // rows in use, packed from 0
+};
+
+// All entities with one exact component set
+class EntityTable {
+public:
+    explicit EntityTable(ComponentMask mask);
+    ~EntityTable();
+    EntityTable(const EntityTable&) = delete;
+    EntityTable& operator=(const EntityTable&) = delete;
+
+    ComponentMask GetMask() const { return mask; }
+    bool Has(ComponentId id) const { return (mask >> id) & 1; }
+    uint32_t GetBlockCapacity() const { return capacity; }
+    size_t GetBlockCount() const { return blocks.size(); }
+    const EntityBlock& GetBlock(size_t i) const { return blocks[i]; }
+    size_t Count() const { return count; }
+    // Blocks allocated, including the spare
+    size_t GetAllocatedBlocks() const { return blocks.size() + (spare ? 1 : 0); }
+
+    // Columns of one of this table's blocks; a const table hands out const data
+    EntityHandle* Handles(const EntityBlock& block) {
+        return reinterpret_cast<EntityHandle*>(block.data + handleOffset);
+    }
+    const EntityHandle* Handles(const EntityBlock& block) const {
+        return reinterpret_cast<const EntityHandle*>(block.data + handleOffset);
+    }
+    void* Column(const EntityBlock& block, ComponentId id) { return block.data + offsets[id]; }
+    const void* Column(const EntityBlock& block, ComponentId id) const { return block.data + offsets[id]; }
+    template <class T>
+    T* Column(const EntityBlock& block) {
+        return reinterpret_cast<T*>(Column(block, ComponentTypeId<T>()));
+    }
+    template <class T>
+    const T* Column(const EntityBlock& block) const {
+        return reinterpret_cast<const T*>(Column(block, ComponentTypeId<T>()));
+    }
+
+    // Add a zeroed row for an entity at the end of the table
+    void Append(EntityHandle handle, uint32_t& block, uint32_t& row);
+    // Add count zeroed rows at once; they follow each other from (block, row)
+    void AppendBatch(const EntityHandle* handles, size_t count, uint32_t& block, uint32_t& row);
+    // Swap-remove a row: the table's last row moves into the hole. Returns the
+    // handle of the entity that moved, or a null handle if none did.
+    EntityHandle Remove(uint32_t block, uint32_t row);
+    // Drop every row (blocks are released, the layout is kept)
+    void Clear();
+
+    // Copy the components both tables have from one row to another
+    static void CopyShared(const EntityTable& src, uint32_t srcBlock, uint32_t srcRow,
+                           EntityTable& dst, uint32_t dstBlock, uint32_t dstRow);
+
+private:
+    void FreeBlock(std::byte* data);
+
+    ComponentMask mask;
+    std::vector<ComponentId> ids;     // components in this set, ascending
+    uint32_t offsets[MAX_COMPONENT_TYPES] = {};
+    uint32_t sizes[MAX_COMPONENT_TYPES] = {}; // copied from the registry
+    uint32_t handleOffset = 0;
+    uint32_t capacity = 0;            // rows per block
+    size_t count = 0;
+    std::vector<EntityBlock> blocks;  // full blocks, then at most one partial one
+    std::byte* spare = nullptr;       // emptied block kept for the next Append
+};
+
+// Owns the tables and maps entity handles to their rows. There is no fixed
+// capacity: blocks are added per table as it fills and handle slots come in
+// pages, so neither a component row nor a Location is ever reallocated by
+// growth elsewhere (only by its own entity moving). Structural changes
+// (Create, Destroy, Add, Remove) move rows around, so they must not happen
+// while a Query is iterating; defer them like EntityManager::DestroyEntity does.
+class EntityWorld {
+public:
+    struct Location {
+        EntityTable* table = nullptr;
+        uint32_t block = 0;
+        uint32_t row = 0;
+    };
+
+    EntityWorld() = default;
+    EntityWorld(const EntityWorld&) = delete;
+    EntityWorld& operator=(const EntityWorld&) = delete;
+
+    // New entity with a zeroed instance of each component in the mask
+    EntityHandle Create(ComponentMask mask);
+    template <class... Ts>
+    EntityHandle Create(const Ts&... values) {
+        EntityHandle handle = Create(ComponentMaskOf<Ts...>());
+        ((*Get<Ts>(handle) = values), ...);
+        return handle;
+    }
+    // Create up to count entities with the same components in one go, writing
+    // their handles out. Their rows are contiguous, so instead of a lookup per
+    // entity, fill(table, block, firstRow, rows, firstIndex) is called once per
+    // block touched to write columns directly; handles[firstIndex + i] owns
+    // row firstRow + i. Returns how many were created (fewer only when the
+    // handle index space runs out).
+    template <class F>
+    size_t CreateBatch(ComponentMask mask, size_t count, EntityHandle* handles, F&& fill) {
+        Location first;
+        const size_t created = CreateBatch(mask, count, handles, first);
+        uint32_t block = first.block;
+        uint32_t row = first.row;
+        for (size_t done = 0; done < created; ++block, row = 0) {
+            const EntityBlock& b = first.table->GetBlock(block);
+            const uint32_t rows = static_cast<uint32_t>(std::min<size_t>(b.count - row, created - done));
+            fill(*first.table, b, row, rows, done);
+            done += rows;
+        }
+        return created;
+    }
+    size_t CreateBatch(ComponentMask mask, size_t count, EntityHandle* handles, Location& first);
+    // Ignores handles that no longer resolve
+    void Destroy(EntityHandle handle);
+    // Destroy everything. Tables survive so queries built against them stay valid,
+    // and slots keep their generations so handles from before never resolve again.
+    void Clear();
+
+    // Row of a live entity, or null (also for destroyed entities whose slot
+    // has been reused). Valid until the next structural change.
+    const Location* Find(EntityHandle handle) const;
+    bool IsAlive(EntityHandle handle) const { return Find(handle) != nullptr; }
+    ComponentMask GetMask(EntityHandle handle) const;
+
+    // Null if the entity is dead or lacks the component
+    template <class T>
+    T* Get(EntityHandle handle) {
+        const Location* loc = Find(handle);
+        if (!loc || !loc->table->Has(ComponentTypeId<T>())) return nullptr;
+        return loc->table->Column<T>(loc->table->GetBlock(loc->block)) + loc->row;
+    }
+    template <class T>
+    const T* Get(EntityHandle handle) const {
+        const Location* loc = Find(handle);
+        if (!loc || !loc->table->Has(ComponentTypeId<T>())) return nullptr;
+        const EntityTable& table = *loc->table;
+        return table.Column<T>(table.GetBlock(loc->block)) + loc->row;
+    }
+    template <class T>
+    bool Has(EntityHandle handle) const { return Get<T>(handle) != nullptr; }
+
+    // Moves the entity to the table with T (if needed) and sets the value
+    template <class T>
+    T* Add(EntityHandle handle, const T& value = T{}) {
+        if (!Move(handle, GetMask(handle) | ComponentMaskOf<T>())) return nullptr;
+        T* component = Get<T>(handle);
+        *component = value;
+        return component;
+    }
+    template <class T>
+    bool Remove(EntityHandle handle) {
+        return Move(handle, GetMask(handle) & ~ComponentMaskOf<T>());
+    }
+
+    struct Stats {
+        size_t live = 0;
+        size_t peak = 0;       // most live at once since the last Clear
+        size_t slots = 0;      // slots ever handed out (live + free + retired)
+        size_t blocks = 0;     // entity blocks allocated across all tables
+        size_t bytes = 0;      // blocks plus slot pages
+    };
+    Stats GetStats() const;
+
+    size_t Count() const { return live; }
+    size_t GetTableCount() const { return tables.size(); }
+    EntityTable& GetTable(size_t i) { return *tables[i]; }
+    const EntityTable& GetTable(size_t i) const { return *tables[i]; }
+
+private:
+    struct Slot {
+        Location loc;
+        uint32_t generation = 1; // bumped when its entity is destroyed
+        bool alive = false;
+    };
+
+    EntityTable& TableFor(ComponentMask mask);
+    bool Move(EntityHandle handle, ComponentMask mask);
+    // Fresh or recycled slot index, or UINT32_MAX when the index space is used up
+    uint32_t AllocateSlot();
+    // Mark a slot dead and recycle (or retire) it
+    void ReleaseSlot(uint32_t i);
+    Slot& SlotAt(uint32_t i) const { return slotPages[i / ENTITY_SLOT_PAGE_SIZE][i % ENTITY_SLOT_PAGE_SIZE]; }
+
+    std::vector<std::unique_ptr<Slot[]>> slotPages;
+    uint32_t slotCount = 0;          // slots in use or free; the rest of the last page is untouched
+    std::vector<uint32_t> freeSlots; // stack of reusable slot indices
+    std::vector<std::unique_ptr<EntityTable>> tables;
+    std::unordered_map<ComponentMask, EntityTable*> tableByMask;
+    size_t live = 0;
+    size_t peak = 0;
+};
+
+// Iterates every entity that has all of Ts (and possibly more, but none of the
+// components in `without`). Matching tables are cached and only new tables are
+// checked on later calls, so a system keeps its queries as members. A query
+// serves a single EntityWorld. Writing through a query needs a mutable world;
+// a const world can only be read, by queries whose components are all const.
+template <class... Ts>
+class Query {
+public:
+    Query() = default;
+    explicit Query(ComponentMask without) : without(without) {}
+
+    // f(size_t count, const EntityHandle* handles, Ts*... columns) per non-empty block
+    template <class F>
+    void ForEachBlock(EntityWorld& world, F&& f) {
+        Visit(world, f);
+    }
+    template <class F>
+    void ForEachBlock(const EntityWorld& world, F&& f) requires (std::is_const_v<Ts> && ...) {
+        Visit(world, f);
+    }
+
+    // f(EntityHandle, Ts&...) per entity
+    template <class F>
+    void ForEach(EntityWorld& world, F&& f) {
+        Visit(world, [&f](size_t count, const EntityHandle* handles, Ts*... columns) {
+            for (size_t i = 0; i < count; ++i) f(handles[i], columns[i]...);
+        });
+    }
+    template <class F>
+    void ForEach(const EntityWorld& world, F&& f) requires (std::is_const_v<Ts> && ...) {
+        Visit(world, [&f](size_t count, const EntityHandle* handles, Ts*... columns) {
+            for (size_t i = 0; i < count; ++i) f(handles[i], columns[i]...);
+        });
+    }
+
+    size_t Count(const EntityWorld& world) {
+        Refresh(world);
+        size_t n = 0;
+        for (size_t t : tables) n += world.GetTable(t).Count();
+        return n;
+    }
+
+private:
+    // World is EntityWorld or const EntityWorld; its tables carry the constness
+    template <class World, class F>
+    void Visit(World& world, F&& f) {
+        Refresh(world);
+        for (size_t t : tables) {
+            auto& table = world.GetTable(t);
+            for (size_t b = 0; b < table.GetBlockCount(); ++b) {
+                const EntityBlock& block = table.GetBlock(b);
+                if (block.count == 0) continue;
+                f(static_cast<size_t>(block.count), static_cast<const EntityHandle*>(table.Handles(block)),
+                  table.template Column<std::remove_const_t<Ts>>(block)...);
+            }
+        }
+    }
+
+    void Refresh(const EntityWorld& world) {
+        const ComponentMask mask = ComponentMaskOf<Ts...>();
+        for (; seen < world.GetTableCount(); ++seen) {
+            const ComponentMask tableMask = world.GetTable(seen).GetMask();
+            if ((tableMask & mask) == mask && (tableMask & without) == 0) tables.push_back(seen);
+        }
+    }
+
+    ComponentMask without = 0;
+    std::vector<size_t> tables; // indices of the matching tables in the world
+    size_t seen = 0;
+};
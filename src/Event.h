@@ -1,5 +1,6 @@
 #pragma once
-#include "Entity.h"
+#include "EntityHandle.h"
+#include <span>
 
 enum class EventType {
     Collision,
@@ -14,10 +15,21 @@ public:
     virtual EventType GetType() const = 0;
 };
 
-// Event for when two entities collide
+// Two entities in contact, lower handle value first
+struct ContactPair {
+    EntityHandle a;
+    EntityHandle b;
+};
+
+// Contact changes from one collision check, fired once per frame when any list
+// is non-empty. The spans point into CollisionSystem's buffers and are only
+// valid during the callback. Holds handles, not pointers: resolve them with
+// EntityManager::FindEntityByID, which fails once an entity is destroyed (an
+// exit is reported the frame after one of the pair is gone).
 struct CollisionEvent : public Event {
-    Entity* entityA;
-    Entity* entityB;
+    std::span<const ContactPair> entered; // started touching this frame
+    std::span<const ContactPair> stayed;  // still touching, rate-limited per pair type
+    std::span<const ContactPair> exited;  // stopped touching this frame
 
     EventType GetType() const override {
         return EventType::Collision;
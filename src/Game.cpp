@@ -3,12 +3,16 @@
 #include "EntityManager.h"
 #include "EventManager.h"
 #include "ArchetypeManager.h"
+#include "ArchetypeWatcher.h"
 #include "Log.h"
 #include "Config.h"
 #include "SystemManager.h"
 #include "Input.h"
 #include "DebugHud.h"
 #include "ChunkManager.h"
+#include "GenerationStages.h"
+#include "ThreadPool.h"
+#include "Benchmarks.h"
 #include <cmath>
 #include <cstdio>
 #include <chrono>
@@ -17,12 +21,18 @@
 void OnCollision(const Event& event) {
     const CollisionEvent& collision = static_cast<const CollisionEvent&>(event);
     bool debugCollisions = Config::GetBool("debug.collision_logs", false);
-    // The collision system already de-duplicates pairs; log at Info if the
-    // user explicitly enabled collision debug, otherwise keep it at Debug.
-    std::string msg = "Collision: A=" + std::to_string(collision.entityA->id)
-        + " B=" + std::to_string(collision.entityB->id);
-    if (debugCollisions) Log::Info(msg);
-    else Log::Warning(msg); // keep visible but less spammy than repeated cout
+    // The collision system reports each contact once on entry; log at Info if
+    // the user explicitly enabled collision debug, otherwise keep it at Debug.
+    for (const ContactPair& contact : collision.entered) {
+        std::string msg = "Collision: A=" + std::to_string(contact.a.Index())
+            + " B=" + std::to_string(contact.b.Index());
+        if (debugCollisions) Log::Info(msg);
+        else Log::Warning(msg); // keep visible but less spammy than repeated cout
+    }
+    if (!debugCollisions) return;
+    for (const ContactPair& contact : collision.exited) {
+        Log::Info("Collision ended: A=" + std::to_string(contact.a.Index()) + " B=" + std::to_string(contact.b.Index()));
+    }
 }
 
 // Provide a single, global instance of the game
@@ -102,6 +112,10 @@ void Game::Init() {
     // Load assets and initialize systems
     // Allow the icon path to be configurable
     AssetManager::LoadAssets();
+    // Background workers for chunk streaming (0 = one less than the core count)
+    ThreadPool::GetInstance().Init(Config::GetInt("jobs.threads", 0));
+    // Optional check that terrain still generates to its recorded hashes (debug.worldgen_check)
+    if (Config::GetBool("debug.worldgen_check", false)) GenerationStages::VerifyGoldenHashes();
     // Initialize chunks/terrain
     ChunkManager::Init();
     // Initialize registered systems
@@ -110,6 +124,7 @@ void Game::Init() {
     // Archetype paths: support a comma-separated list in config
     std::string apaths = Config::GetString("archetypes.paths", "res/archetypes,../res/archetypes");
     bool loadedAny = false;
+    std::string loadedPath;
     size_t start = 0;
     while (start < apaths.size()) {
         size_t comma = apaths.find(',', start);
@@ -123,6 +138,7 @@ void Game::Init() {
             if (ArchetypeManager::GetInstance().GetLoadedCount() > 0) {
                 Log::Info(std::string("Loaded archetypes from: ") + path);
                 loadedAny = true;
+                loadedPath = path;
                 break;
             }
         }
@@ -131,7 +147,12 @@ void Game::Init() {
     }
     if (!loadedAny) {
         Log::Warning("No archetypes loaded; checked common paths");
+    } else if (Config::GetBool("archetypes.hot_reload", false)) {
+        ArchetypeWatcher::Init(loadedPath);
     }
+    // Optional startup micro-benchmarks (debug.benchmarks); after archetypes load
+    // so the spawn benchmark has one to use
+    Benchmarks::RunFromConfig();
     EntityManager::GetInstance().Init();
 
     // Subscribe to events
@@ -215,11 +236,11 @@ void Game::Update() {
         // Rebuild the HUD buffer (include profiler timings when enabled)
         if (profilerEnabled) {
             debugHudBufLen = std::snprintf(debugHudBuf, sizeof(debugHudBuf),
-                "pos=%.2f,%.2f,%.2f tgt=%.2f,%.2f,%.2f yaw=%.2f pitch=%.2f sens=%.2f | U=%.2f C=%.2f E=%.2f R=%.2f F=%.2fms",
+                "pos=%.2f,%.2f,%.2f tgt=%.2f,%.2f,%.2f yaw=%.2f pitch=%.2f sens=%.2f | U=%.2f C=%.2f S=%.2f E=%.2f R=%.2f F=%.2fms",
                 camera.position.x, camera.position.y, camera.position.z,
                 camera.target.x, camera.target.y, camera.target.z,
                 cameraYaw, cameraPitch, cameraSensitivity,
-                lastUpdateMs, lastCameraMs, lastEntityMs, lastRenderMs, lastFrameMs);
+                lastUpdateMs, lastCameraMs, lastStreamMs, lastEntityMs, lastRenderMs, lastFrameMs);
         } else {
             debugHudBufLen = std::snprintf(debugHudBuf, sizeof(debugHudBuf),
                 "pos=%.2f,%.2f,%.2f tgt=%.2f,%.2f,%.2f yaw=%.2f pitch=%.2f sens=%.2f",
@@ -229,6 +250,46 @@ void Game::Update() {
         }
         if (debugHudBufLen < 0) debugHudBufLen = 0;
         if (debugHudBufLen >= static_cast<int>(sizeof(debugHudBuf))) debugHudBufLen = static_cast<int>(sizeof(debugHudBuf)) - 1;
+        // Terrain culling counters from the last rendered frame
+        const ChunkManager::RenderStats& cs = ChunkManager::GetRenderStats();
+        const ChunkManager::StreamStats& ss = ChunkManager::GetStreamStats();
+        int more = std::snprintf(debugHudBuf + debugHudBufLen, sizeof(debugHudBuf) - debugHudBufLen,
+            "\nchunks drawn=%d/%d occluded=%d outside=%d | stream pending=%d jobs=%d",
+            cs.drawn, cs.loaded, cs.occluded, cs.outsideView, ss.pending, ss.inFlight);
+        if (more > 0) debugHudBufLen += more;
+        if (debugHudBufLen >= static_cast<int>(sizeof(debugHudBuf))) debugHudBufLen = static_cast<int>(sizeof(debugHudBuf)) - 1;
+        const ChunkManager::CacheStats& cache = ChunkManager::GetCacheStats();
+        more = std::snprintf(debugHudBuf + debugHudBufLen, sizeof(debugHudBuf) - debugHudBufLen,
+            "\ncache cpu=%.1f/%.0fMB gpu=%.1f/%.0fMB hit=%llu miss=%llu evict mesh=%llu blocks=%llu",
+            cache.cpuBytes / 1048576.0, cache.cpuBudget / 1048576.0,
+            cache.gpuBytes / 1048576.0, cache.gpuBudget / 1048576.0,
+            static_cast<unsigned long long>(cache.blockHits + cache.meshHits),
+            static_cast<unsigned long long>(cache.blockMisses + cache.meshMisses),
+            static_cast<unsigned long long>(cache.meshEvictions),
+            static_cast<unsigned long long>(cache.blockEvictions));
+        if (more > 0) debugHudBufLen += more;
+        if (debugHudBufLen >= static_cast<int>(sizeof(debugHudBuf))) debugHudBufLen = static_cast<int>(sizeof(debugHudBuf)) - 1;
+        const EntityWorld::Stats es = EntityManager::GetInstance().GetStats();
+        const size_t entityBudget = EntityManager::GetInstance().GetBudget();
+        more = std::snprintf(debugHudBuf + debugHudBufLen, sizeof(debugHudBuf) - debugHudBufLen,
+            "\nentities live=%zu peak=%zu budget=%zu blocks=%zu mem=%.1fMB",
+            es.live, es.peak, entityBudget, es.blocks, es.bytes / 1048576.0);
+        if (more > 0) debugHudBufLen += more;
+        if (debugHudBufLen >= static_cast<int>(sizeof(debugHudBuf))) debugHudBufLen = static_cast<int>(sizeof(debugHudBuf)) - 1;
+        // Average time per chunk in each world generation stage
+        if (profilerEnabled) {
+            if (const GenerationPipeline* gen = ChunkManager::GetGenerator()) {
+                more = std::snprintf(debugHudBuf + debugHudBufLen, sizeof(debugHudBuf) - debugHudBufLen, "\ngen us/chunk");
+                if (more > 0) debugHudBufLen += more;
+                for (const auto& st : gen->GetStageStats()) {
+                    if (debugHudBufLen >= static_cast<int>(sizeof(debugHudBuf)) - 1) break;
+                    more = std::snprintf(debugHudBuf + debugHudBufLen, sizeof(debugHudBuf) - debugHudBufLen,
+                        " %s=%.1f", st.name, st.avgMicros);
+                    if (more > 0) debugHudBufLen += more;
+                }
+                if (debugHudBufLen >= static_cast<int>(sizeof(debugHudBuf))) debugHudBufLen = static_cast<int>(sizeof(debugHudBuf)) - 1;
+            }
+        }
         debugHudBuf[debugHudBufLen] = '\0';
     }
 
@@ -246,8 +307,14 @@ void Game::Update() {
     UpdateCameraControls(scaledDeltaTime, mouseDelta);
     auto camEnd = std::chrono::high_resolution_clock::now();
 
-    // Profile entity updates
+    // Stream terrain around the (just moved) camera
+    auto streamStart = std::chrono::high_resolution_clock::now();
+    ChunkManager::Update(camera.position);
+    auto streamEnd = std::chrono::high_resolution_clock::now();
+
+    // Profile entity updates (archetype edits are applied first, outside the systems)
     auto entStart = std::chrono::high_resolution_clock::now();
+    ArchetypeWatcher::Update(GetFrameTime());
     EntityManager::GetInstance().UpdateAll(scaledDeltaTime);
     auto entEnd = std::chrono::high_resolution_clock::now();
 
@@ -258,6 +325,7 @@ void Game::Update() {
     if (profilerEnabled) {
         lastCameraMs = std::chrono::duration<double, std::milli>(camEnd - camStart).count();
         lastEntityMs = std::chrono::duration<double, std::milli>(entEnd - entStart).count();
+        lastStreamMs = std::chrono::duration<double, std::milli>(streamEnd - streamStart).count();
     }
 
     auto frameEnd = std::chrono::high_resolution_clock::now();
@@ -303,8 +371,10 @@ void Game::Render() {
 
 // Unload assets and close the window
 void Game::Shutdown() {
+    ArchetypeWatcher::Shutdown();
     AssetManager::UnloadAssets();
     ChunkManager::Shutdown();
+    ThreadPool::GetInstance().Shutdown();
     SystemManager::GetInstance().ShutdownAll();
     EnableCursor();
     CloseWindow();
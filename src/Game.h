@@ -40,7 +40,7 @@ private:
     // Debug HUD throttling (cached string updated at debugHudInterval)
     float debugHudTimer = 0.0f;
     float debugHudInterval = 0.1f; // seconds (10 Hz)
-    char debugHudBuf[256] = {0};
+    char debugHudBuf[768] = {0};
     int debugHudBufLen = 0;
     // Lightweight profiler (ms)
     bool profilerEnabled = true;
@@ -49,4 +49,5 @@ private:
     double lastRenderMs = 0.0;
     double lastCameraMs = 0.0;
     double lastEntityMs = 0.0;
+    double lastStreamMs = 0.0;
 };
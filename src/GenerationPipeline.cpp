@@ -0,0 +1,125 @@
+#include "GenerationPipeline.h"
+#include "Log.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t NanosSince(Clock::time_point start) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+
+    int FloorDiv(int a, int b) {
+        return a >= 0 ? a / b : -((-a + b - 1) / b);
+    }
+
+    // Column data is finished before any chunk pass runs, so it never orders stages
+    bool Conflicts(const GenStage& a, const GenStage& b) {
+        const uint32_t mask = ~static_cast<uint32_t>(GEN_COLUMNS);
+        return ((a.Reads() & b.Writes()) | (a.Writes() & b.Reads()) | (a.Writes() & b.Writes())) & mask;
+    }
+}
+
+// --- GenContext ---
+
+std::shared_ptr<const ColumnData> GenContext::ColumnAt(int cx, int cz) const {
+    return pipeline.GetColumn(cx, cz, size);
+}
+
+void GenContext::SetWorld(int wx, int wy, int wz, BlockId id) {
+    if (FloorDiv(wx, size) != coord.x || FloorDiv(wy, size) != coord.y || FloorDiv(wz, size) != coord.z) return;
+    BlockId& b = blocks[Index(wx - coord.x * size, wy - coord.y * size, wz - coord.z * size)];
+    if (b == 0) b = id;
+}
+
+// --- GenerationPipeline ---
+
+GenerationPipeline::GenerationPipeline(uint32_t seed) : seed(seed) {}
+
+void GenerationPipeline::AddStage(std::unique_ptr<GenStage> stage) {
+    uint32_t written = 0;
+    for (const auto& s : stages) written |= s->Writes();
+    written |= stage->Writes() & GEN_COLUMNS;
+    if (uint32_t missing = stage->Reads() & ~written) {
+        Log::Warning(std::string("GenerationPipeline: stage '") + stage->Name() + "' reads data no earlier stage writes (flags " +
+                     std::to_string(missing) + ")");
+    }
+
+    const int index = static_cast<int>(stages.size());
+    bool joinsLast = !phases.empty();
+    if (joinsLast) {
+        for (int other : phases.back()) {
+            if (Conflicts(*stages[other], *stage)) { joinsLast = false; break; }
+        }
+    }
+    if (joinsLast) phases.back().push_back(index);
+    else phases.push_back({ index });
+
+    stages.push_back(std::move(stage));
+    timings.push_back(std::make_unique<Timing>());
+}
+
+std::string GenerationPipeline::DescribePhases() const {
+    std::string out;
+    for (const auto& phase : phases) {
+        out += out.empty() ? "[" : " [";
+        for (size_t i = 0; i < phase.size(); ++i) {
+            if (i) out += ", ";
+            out += stages[phase[i]]->Name();
+        }
+        out += "]";
+    }
+    return out;
+}
+
+void GenerationPipeline::BuildColumn(int cx, int cz, int size, ColumnData& out) {
+    auto start = Clock::now();
+    out.size = size;
+    for (const auto& stage : stages) {
+        if (stage->Writes() & GEN_COLUMNS) stage->BuildColumn(cx, cz, size, seed, out);
+    }
+    out.minHeight = INT_MAX;
+    out.maxHeight = INT_MIN;
+    for (int h : out.heights) {
+        out.minHeight = std::min(out.minHeight, h);
+        out.maxHeight = std::max(out.maxHeight, h);
+    }
+    columnTiming.nanos.fetch_add(NanosSince(start), std::memory_order_relaxed);
+    columnTiming.runs.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::shared_ptr<const ColumnData> GenerationPipeline::GetColumn(int cx, int cz, int chunkSize) {
+    return columns.GetOrBuild(cx, cz, [&](int x, int z, ColumnData& out) {
+        BuildColumn(x, z, chunkSize, out);
+    });
+}
+
+void GenerationPipeline::GenerateChunk(const ChunkCoord& coord, BlockId* outBlocks, int chunkSize) {
+    auto column = GetColumn(coord.x, coord.z, chunkSize);
+    GenContext ctx{ coord, chunkSize, outBlocks, *column, seed, *this };
+
+    // Chunks are the unit of parallel work (one pool job each), so phases run in order here
+    for (const auto& phase : phases) {
+        for (int i : phase) {
+            auto start = Clock::now();
+            stages[i]->Run(ctx);
+            timings[i]->nanos.fetch_add(NanosSince(start), std::memory_order_relaxed);
+            timings[i]->runs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+std::vector<GenerationPipeline::StageStats> GenerationPipeline::GetStageStats() const {
+    auto stats = [](const char* name, const Timing& t) {
+        uint64_t runs = t.runs.load(std::memory_order_relaxed);
+        uint64_t nanos = t.nanos.load(std::memory_order_relaxed);
+        return StageStats{ name, runs, runs ? nanos / 1000.0 / runs : 0.0 };
+    };
+    std::vector<StageStats> out;
+    out.reserve(stages.size() + 1);
+    out.push_back(stats("columns", columnTiming));
+    for (size_t i = 0; i < stages.size(); ++i) out.push_back(stats(stages[i]->Name(), *timings[i]));
+    return out;
+}
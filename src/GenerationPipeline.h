@@ -0,0 +1,89 @@
+#pragma once
+#include "WorldGenerator.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Data a generation stage can read or write (bit flags)
+enum GenData : uint32_t {
+    GEN_COLUMNS  = 1u << 0, // cached 2D column data (heights, biome, surface)
+    GEN_SHAPE    = 1u << 1, // which blocks are solid
+    GEN_MATERIAL = 1u << 2, // which block id a solid block is
+    GEN_FEATURES = 1u << 3  // features crossing chunk borders (each chunk places its part)
+};
+
+class GenerationPipeline;
+
+// Per-chunk state handed to each stage
+struct GenContext {
+    ChunkCoord coord;
+    int size;
+    BlockId* blocks;          // size^3, index x + z*size + y*size*size
+    const ColumnData& column; // this chunk's column
+    uint32_t seed;
+    GenerationPipeline& pipeline;
+
+    int Index(int x, int y, int z) const { return x + z * size + y * size * size; }
+    BlockId Get(int x, int y, int z) const { return blocks[Index(x, y, z)]; }
+    void Set(int x, int y, int z, BlockId id) { blocks[Index(x, y, z)] = id; }
+    // Column data of another chunk column, for features rooted there that reach into this chunk
+    std::shared_ptr<const ColumnData> ColumnAt(int cx, int cz) const;
+    // Place a feature block by world position, filling air only. Positions outside
+    // this chunk are skipped: the chunk they fall in places them itself, so every
+    // chunk's blocks depend on nothing but the seed and its coordinates.
+    void SetWorld(int wx, int wy, int wz, BlockId id);
+};
+
+class GenStage {
+public:
+    virtual ~GenStage() = default;
+    virtual const char* Name() const = 0;
+    virtual uint32_t Reads() const = 0;  // GenData flags
+    virtual uint32_t Writes() const = 0; // GenData flags
+    // 2D pass, run once per chunk column and cached (for stages that write GEN_COLUMNS)
+    virtual void BuildColumn(int cx, int cz, int size, uint32_t seed, ColumnData& column) const {
+        (void)cx; (void)cz; (void)size; (void)seed; (void)column;
+    }
+    // 3D pass, run for every chunk. Called concurrently from worker threads.
+    virtual void Run(GenContext& ctx) const = 0;
+};
+
+// World generator built from a list of stages. Stages run in the order they
+// were added; consecutive stages whose reads/writes don't overlap are grouped
+// into phases, the unit a scheduler may run side by side.
+class GenerationPipeline : public WorldGenerator {
+public:
+    explicit GenerationPipeline(uint32_t seed = 0);
+
+    void AddStage(std::unique_ptr<GenStage> stage);
+    void GenerateChunk(const ChunkCoord& coord, BlockId* outBlocks, int chunkSize) override;
+    // Cached column data for chunk column (cx, cz), built on first use
+    std::shared_ptr<const ColumnData> GetColumn(int cx, int cz, int chunkSize);
+
+    const std::vector<std::vector<int>>& GetPhases() const { return phases; }
+    std::string DescribePhases() const;
+    uint32_t GetSeed() const { return seed; }
+
+    struct StageStats {
+        const char* name;
+        uint64_t runs;
+        double avgMicros; // per chunk (per column for the column pass)
+    };
+    // Column pass first, then one entry per stage
+    std::vector<StageStats> GetStageStats() const;
+
+private:
+    struct Timing {
+        std::atomic<uint64_t> nanos{ 0 };
+        std::atomic<uint64_t> runs{ 0 };
+    };
+
+    void BuildColumn(int cx, int cz, int size, ColumnData& out);
+
+    uint32_t seed;
+    std::vector<std::unique_ptr<GenStage>> stages;
+    std::vector<std::vector<int>> phases;
+    std::vector<std::unique_ptr<Timing>> timings; // parallel to stages
+    Timing columnTiming;
+};
@@ -0,0 +1,281 @@
+#include "GenerationStages.h"
+#include "Chunk.h"
+#include "HeightmapGenerator.h"
+#include "PerlinNoise.h"
+#include "Random.h"
+#include "Config.h"
+#include "Log.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+    // Heightmap columns; every block at or below the height becomes stone
+    class TerrainStage : public GenStage {
+    public:
+        explicit TerrainStage(uint32_t seed) : heightmap(seed) {}
+
+        const char* Name() const override { return "terrain"; }
+        uint32_t Reads() const override { return GEN_COLUMNS; }
+        uint32_t Writes() const override { return GEN_COLUMNS | GEN_SHAPE | GEN_MATERIAL; }
+
+        void BuildColumn(int cx, int cz, int size, uint32_t, ColumnData& column) const override {
+            heightmap.BuildColumn(cx, cz, size, column);
+        }
+        void Run(GenContext& ctx) const override {
+            HeightmapGenerator::FillFromColumn(ctx.column, ctx.coord, ctx.size, Blocks::STONE, ctx.blocks);
+        }
+
+    private:
+        HeightmapGenerator heightmap;
+    };
+
+    // Repaint the top few solid blocks of each column with its surface block
+    class SurfaceStage : public GenStage {
+    public:
+        static constexpr int DEPTH = 3;
+
+        const char* Name() const override { return "surface"; }
+        uint32_t Reads() const override { return GEN_COLUMNS | GEN_SHAPE; }
+        uint32_t Writes() const override { return GEN_MATERIAL; }
+
+        void Run(GenContext& ctx) const override {
+            const ColumnData& col = ctx.column;
+            const int S = ctx.size;
+            const int wy0 = ctx.coord.y * S;
+            if (col.maxHeight < wy0 || col.minHeight - DEPTH + 1 >= wy0 + S) return;
+            // Walk each column's surface band directly rather than whole layers
+            for (int i = 0; i < S * S; ++i) {
+                const int h = col.heights[i];
+                const int yBegin = std::max(0, h - DEPTH + 1 - wy0);
+                const int yEnd = std::min(S, h + 1 - wy0);
+                for (int y = yBegin; y < yEnd; ++y) {
+                    BlockId& block = ctx.blocks[i + y * S * S];
+                    if (block != Blocks::AIR) block = col.surface[i];
+                }
+            }
+        }
+    };
+
+    // Tunnels where two 3D noise fields both sit near their midpoint, sampled
+    // on a coarse lattice and interpolated; a crust under the surface is kept
+    class CaveStage : public GenStage {
+    public:
+        static constexpr int STEP = 8;      // lattice spacing in blocks
+        static constexpr int CRUST = 4;     // solid blocks kept under the surface
+        static constexpr float FREQ = 1.0f / 32.0f;
+        static constexpr float WIDTH = 0.06f;
+
+        explicit CaveStage(uint32_t seed) : noiseA(seed ^ 0xCA7E0001u), noiseB(seed ^ 0xCA7E0002u) {}
+
+        const char* Name() const override { return "caves"; }
+        uint32_t Reads() const override { return GEN_COLUMNS | GEN_SHAPE; }
+        uint32_t Writes() const override { return GEN_SHAPE; }
+
+        void Run(GenContext& ctx) const override {
+            const int S = ctx.size;
+            const int wy0 = ctx.coord.y * S;
+            if (wy0 > ctx.column.maxHeight - CRUST) return;
+
+            const int n = S / STEP + 1;
+            float a[8 * 8 * 8], b[8 * 8 * 8];
+            if (n > 8) return;
+            const float step = STEP * FREQ;
+            const float x0 = ctx.coord.x * S * FREQ + 0.31f;
+            const float y0 = wy0 * FREQ + 0.17f;
+            const float z0 = ctx.coord.z * S * FREQ + 0.43f;
+            noiseA.noiseGrid3(x0, y0, z0, step, n, n, n, a, 2);
+            noiseB.noiseGrid3(x0 + 57.0f, y0, z0 + 91.0f, step, n, n, n, b, 2);
+
+            // Fold both fields into one carve value: how far the worse of the two is from 0.5
+            float lattice[8 * 8 * 8];
+            for (int i = 0; i < n * n * n; ++i) lattice[i] = std::max(std::fabs(a[i] - 0.5f), std::fabs(b[i] - 0.5f));
+
+            // Separable interpolation: along y once per layer, along z once per row,
+            // leaving one lerp per block along x
+            const float inv = 1.0f / STEP;
+            float plane[8 * 8], row[8];
+            for (int y = 0; y < S; ++y) {
+                const int wy = wy0 + y;
+                if (wy > ctx.column.maxHeight - CRUST) break;
+                const float* lo = lattice + (y / STEP) * n * n;
+                const float* hi = lo + n * n;
+                const float fy = (y % STEP) * inv;
+                for (int i = 0; i < n * n; ++i) plane[i] = lo[i] + (hi[i] - lo[i]) * fy;
+
+                for (int z = 0; z < S; ++z) {
+                    const float* r0 = plane + (z / STEP) * n;
+                    const float* r1 = r0 + n;
+                    const float fz = (z % STEP) * inv;
+                    for (int i = 0; i < n; ++i) row[i] = r0[i] + (r1[i] - r0[i]) * fz;
+
+                    BlockId* dst = ctx.blocks + ctx.Index(0, y, z);
+                    const int* heights = ctx.column.heights.data() + z * S;
+                    for (int x = 0; x < S; ++x) {
+                        const int i = x / STEP;
+                        const float v = row[i] + (row[i + 1] - row[i]) * ((x % STEP) * inv);
+                        if (v < WIDTH && wy <= heights[x] - CRUST) dst[x] = Blocks::AIR;
+                    }
+                }
+            }
+        }
+
+    private:
+        PerlinNoise noiseA;
+        PerlinNoise noiseB;
+    };
+
+    // Small ore blobs inside stone, kept within the chunk
+    class OreStage : public GenStage {
+    public:
+        static constexpr int BLOBS = 6;
+
+        const char* Name() const override { return "ores"; }
+        uint32_t Reads() const override { return GEN_SHAPE | GEN_MATERIAL; }
+        uint32_t Writes() const override { return GEN_MATERIAL; }
+
+        void Run(GenContext& ctx) const override {
+            const int S = ctx.size;
+            if (ctx.coord.y * S > ctx.column.maxHeight) return;
+            Random::Pcg32 rng(Random::Hash(ctx.seed ^ 0x0E5E0E5Eu, ctx.coord.x, ctx.coord.y, ctx.coord.z));
+            for (int n = 0; n < BLOBS; ++n) {
+                const int cx = rng.Range(S), cy = rng.Range(S), cz = rng.Range(S);
+                const int r2 = 1 + rng.Range(2); // radius^2 of 1 or 2
+                for (int y = std::max(0, cy - 1); y <= std::min(S - 1, cy + 1); ++y)
+                    for (int z = std::max(0, cz - 1); z <= std::min(S - 1, cz + 1); ++z)
+                        for (int x = std::max(0, cx - 1); x <= std::min(S - 1, cx + 1); ++x) {
+                            int dx = x - cx, dy = y - cy, dz = z - cz;
+                            if (dx * dx + dy * dy + dz * dz > r2) continue;
+                            BlockId& block = ctx.blocks[ctx.Index(x, y, z)];
+                            if (block == Blocks::STONE) block = Blocks::ORE;
+                        }
+            }
+        }
+    };
+
+    // Stone boulders resting on the surface, at most one per chunk column. A
+    // boulder near a column edge reaches into its neighbors, so each chunk
+    // places the part of every boulder within reach that falls inside it.
+    class BoulderStage : public GenStage {
+    public:
+        static constexpr int CHANCE = 3;     // one boulder in this many chunk columns
+        static constexpr int MAX_RADIUS = 2; // less than a chunk, so only adjacent columns reach in
+
+        const char* Name() const override { return "boulders"; }
+        uint32_t Reads() const override { return GEN_COLUMNS | GEN_SHAPE; }
+        uint32_t Writes() const override { return GEN_SHAPE | GEN_MATERIAL | GEN_FEATURES; }
+
+        void Run(GenContext& ctx) const override {
+            const int S = ctx.size;
+            for (int sz = ctx.coord.z - 1; sz <= ctx.coord.z + 1; ++sz)
+                for (int sx = ctx.coord.x - 1; sx <= ctx.coord.x + 1; ++sx) Place(ctx, sx, sz, S);
+        }
+
+    private:
+        // The boulder rooted in chunk column (sx, sz), if it has one
+        void Place(GenContext& ctx, int sx, int sz, int S) const {
+            Random::Pcg32 rng(Random::Hash(ctx.seed ^ 0xB0D1DE75u, sx, 0, sz));
+            if (rng.Range(CHANCE) != 0) return;
+            const int lx = rng.Range(S), lz = rng.Range(S);
+            const int radius = 1 + rng.Range(MAX_RADIUS);
+            const int wx = sx * S + lx, wz = sz * S + lz;
+            // Skip boulders that can't touch this chunk before fetching their column
+            const int x0 = ctx.coord.x * S, z0 = ctx.coord.z * S;
+            if (wx + radius < x0 || wx - radius >= x0 + S || wz + radius < z0 || wz - radius >= z0 + S) return;
+
+            const bool own = sx == ctx.coord.x && sz == ctx.coord.z;
+            std::shared_ptr<const ColumnData> other = own ? nullptr : ctx.ColumnAt(sx, sz);
+            const ColumnData& column = own ? ctx.column : *other;
+            const int base = column.heights[lx + lz * S] + 1;
+            const int y0 = ctx.coord.y * S;
+            if (base + radius < y0 || base - radius >= y0 + S) return;
+
+            for (int dy = -radius; dy <= radius; ++dy)
+                for (int dz = -radius; dz <= radius; ++dz)
+                    for (int dx = -radius; dx <= radius; ++dx) {
+                        if (dx * dx + dy * dy + dz * dz > radius * radius) continue;
+                        ctx.SetWorld(wx + dx, base + dy, wz + dz, Blocks::STONE);
+                    }
+        }
+    };
+}
+
+namespace GenerationStages {
+    Settings LoadSettings() {
+        Settings s;
+        s.seed = Random::SeedFromString(Config::GetString("worldgen.seed", "0"));
+        s.caves = Config::GetBool("worldgen.caves", s.caves);
+        s.ores = Config::GetBool("worldgen.ores", s.ores);
+        s.boulders = Config::GetBool("worldgen.boulders", s.boulders);
+        return s;
+    }
+
+    std::unique_ptr<GenerationPipeline> CreateWorldPipeline(const Settings& settings) {
+        auto pipeline = std::make_unique<GenerationPipeline>(settings.seed);
+        pipeline->AddStage(std::make_unique<TerrainStage>(settings.seed));
+        pipeline->AddStage(std::make_unique<SurfaceStage>());
+        if (settings.caves) pipeline->AddStage(std::make_unique<CaveStage>(settings.seed));
+        if (settings.ores) pipeline->AddStage(std::make_unique<OreStage>());
+        if (settings.boulders) pipeline->AddStage(std::make_unique<BoulderStage>());
+        return pipeline;
+    }
+
+    uint64_t HashChunk(uint32_t seed, const ChunkCoord& coord) {
+        Settings settings;
+        settings.seed = seed;
+        auto pipeline = CreateWorldPipeline(settings);
+        const int S = Chunk::SIZE;
+        std::vector<BlockId> blocks(S * S * S);
+        pipeline->GenerateChunk(coord, blocks.data(), S);
+
+        uint64_t h = 14695981039346656037ull;
+        for (BlockId b : blocks) {
+            h ^= b;
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    bool VerifyGoldenHashes() {
+        struct Golden {
+            uint32_t seed;
+            ChunkCoord coord;
+            uint64_t hash;
+        };
+        static const Golden GOLDEN[] = {
+            { 0u, { 0, 0, 0 }, 0x22CB248E6E43D0F6ull },
+            { 0u, { -3, -1, 5 }, 0x58756CAF581A3D9Bull },
+            { 0u, { 17, 0, -42 }, 0x709E38EE604AC106ull },
+            { 0u, { 1000, -1, -1000 }, 0x7FA5A46258A3C74Full },
+            { 1u, { 0, 0, 0 }, 0x7CEBD6E0D2DC92C1ull },
+            { 1u, { -3, -1, 5 }, 0x777EC752BEF21C5Aull },
+            { 1u, { 17, 0, -42 }, 0xAC947CC1E7D047C9ull },
+            { 1u, { 1000, -1, -1000 }, 0x6155545B7D646995ull },
+            { 1337u, { 0, 0, 0 }, 0x4E0D2571ACB47D42ull },
+            { 1337u, { -3, -1, 5 }, 0x1955D74741E0C52Dull },
+            { 1337u, { 17, 0, -42 }, 0x52C0B770486A8CC6ull },
+            { 1337u, { 1000, -1, -1000 }, 0xECD2A54647604B17ull },
+            { 3735928559u, { 0, 0, 0 }, 0x16A0E2AF0FB67F1Dull },
+            { 3735928559u, { -3, -1, 5 }, 0x177A7FBE517687C6ull },
+            { 3735928559u, { 17, 0, -42 }, 0x3E018DEE4927E8E7ull },
+            { 3735928559u, { 1000, -1, -1000 }, 0xDBD81D4551B510F7ull },
+        };
+
+        int failed = 0;
+        for (const Golden& g : GOLDEN) {
+            uint64_t h = HashChunk(g.seed, g.coord);
+            if (h == g.hash) continue;
+            ++failed;
+            char line[160];
+            std::snprintf(line, sizeof(line), "GenerationStages: seed %" PRIu32 " chunk %d,%d,%d hashes to %016" PRIx64 ", expected %016" PRIx64,
+                          g.seed, g.coord.x, g.coord.y, g.coord.z, h, g.hash);
+            Log::Error(line);
+        }
+        const int total = static_cast<int>(sizeof(GOLDEN) / sizeof(GOLDEN[0]));
+        if (failed) Log::Error("GenerationStages: " + std::to_string(failed) + "/" + std::to_string(total) + " golden chunks changed");
+        else Log::Info("GenerationStages: " + std::to_string(total) + " golden chunks match");
+        return failed == 0;
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "GenerationPipeline.h"
+#include <memory>
+
+// Built-in world generation stages and the pipeline the game streams from
+namespace GenerationStages {
+    struct Settings {
+        uint32_t seed = 0;
+        bool caves = true;
+        bool ores = true;
+        bool boulders = true;
+    };
+
+    // worldgen.* keys from config.ini
+    Settings LoadSettings();
+
+    // terrain -> surface -> caves -> ores -> boulders (optional stages per settings)
+    std::unique_ptr<GenerationPipeline> CreateWorldPipeline(const Settings& settings);
+
+    // FNV-1a hash of one chunk's blocks from a fresh all-stages pipeline
+    uint64_t HashChunk(uint32_t seed, const ChunkCoord& coord);
+
+    // Compare HashChunk for fixed seeds and chunks against values recorded when
+    // generation last changed on purpose; logs each mismatch (debug.worldgen_check).
+    // Regenerating unedited chunks instead of saving them relies on this holding.
+    bool VerifyGoldenHashes();
+}
@@ -1,6 +1,7 @@
 #include "GreedyMesher.h"
 #include "Log.h"
 #include "AssetManager.h"
+#include "ChunkOcclusion.h"
 #include <array>
 #include <vector>
 #include <cstring>
@@ -113,6 +114,9 @@ bool GreedyMesher::MeshChunk(Chunk& chunk) {
 
 bool GreedyMesher::MeshChunk(Chunk& chunk, std::function<BlockId(int,int,int)> neighborSampler) {
     const int S = Chunk::SIZE;
+    // Refresh the occlusion summary alongside the mesh so both describe the same blocks
+    chunk.faceConnectivity = ChunkOcclusion::ComputeFaceConnectivity(chunk);
+
     std::vector<float> vertices;
     std::vector<float> normals;
     std::vector<float> uvs;
@@ -238,11 +242,8 @@ bool GreedyMesher::MeshChunk(Chunk& chunk, std::function<BlockId(int,int,int)> n
     }
 
     if (vertices.empty()) {
-        if (chunk.hasModel) {
-            UnloadModel(chunk.model);
-            chunk.hasModel = false;
-        }
-        chunk.quads.clear();
+        chunk.ReleaseModel();
+        chunk.meshDirty = false;
         return true;
     }
 
@@ -269,10 +270,19 @@ bool GreedyMesher::MeshChunk(Chunk& chunk, std::function<BlockId(int,int,int)> n
         UnloadModel(chunk.model);
     }
 
+    // The fallback atlas is resolved once and shared by every chunk; probing the
+    // disk (and leaking a texture) per mesh stalls streaming
+    static Texture2D fallbackAtlas = {};
+    static bool fallbackTried = false;
+
     Texture2D atlas = {};
     try {
         atlas = AssetManager::GetTexture("blocks");
     } catch (const std::out_of_range&) {
+        atlas = fallbackAtlas;
+    }
+    if (atlas.id == 0 && !fallbackTried) {
+        fallbackTried = true;
         // Fallback: try to load the atlas directly if AssetManager didn't
         Log::Warning("GreedyMesher: atlas not in AssetManager; attempting fallback load");
         std::vector<std::string> candidates = {
@@ -294,6 +304,7 @@ bool GreedyMesher::MeshChunk(Chunk& chunk, std::function<BlockId(int,int,int)> n
                 }
             }
         }
+        fallbackAtlas = atlas;
     }
 
     if (atlas.id != 0) {
@@ -305,8 +316,11 @@ bool GreedyMesher::MeshChunk(Chunk& chunk, std::function<BlockId(int,int,int)> n
     chunk.model = model;
     chunk.hasModel = true;
     chunk.quads = quads;
+    chunk.meshDirty = false;
+    chunk.meshBytes = vertices.size() * sizeof(float) + normals.size() * sizeof(float) +
+                      uvs.size() * sizeof(float) + colors.size() + indices.size() * sizeof(unsigned short);
 
-    Log::Info("GreedyMesher: quads=" + std::to_string(quads.size()) +
+    Log::Debug("GreedyMesher: quads=" + std::to_string(quads.size()) +
               " verts=" + std::to_string(mesh.vertexCount));
 
     return true;
@@ -1,41 +1,105 @@
 #include "HeightmapGenerator.h"
+#include "SimdMath.h"
+#include "Random.h"
+#include <algorithm>
+#include <climits>
 #include <cmath>
+#include <cstring>
+#include <vector>
 
-HeightmapGenerator::HeightmapGenerator() {}
+namespace {
+    const float BASE = 4.0f; // base elevation
+    const float AMP = 6.0f;  // amplitude
+    const uint8_t BIOME_PLAINS = 0;
 
-// Simple pseudo-noise function: combines sines for a deterministic heightfield.
-static float pseudoNoise(int x, int z, float scale) {
-    float fx = static_cast<float>(x) * scale;
-    float fz = static_cast<float>(z) * scale;
-    return (std::sin(fx * 0.12f) + std::sin(fz * 0.08f) * 0.8f + std::sin((fx+fz) * 0.05f) * 0.5f) * 0.5f;
+    // Seed -> phase in [0, 2pi), from the top 24 hash bits so the float is exact
+    float PhaseFor(uint32_t seed, int term) {
+        return static_cast<float>(Random::Hash(seed, term, 0, 0) >> 8) * (6.28318531f / 16777216.0f);
+    }
 }
 
+HeightmapGenerator::HeightmapGenerator(uint32_t seed)
+    : seed(seed), phaseX(PhaseFor(seed, 0)), phaseZ(PhaseFor(seed, 1)), phaseXZ(PhaseFor(seed, 2)) {}
+
+// Simple pseudo-noise function: combines sines for a deterministic heightfield.
 float HeightmapGenerator::SampleHeight(int wx, int wz) const {
-    float n = pseudoNoise(wx, wz, 1.0f);
-    float base = 4.0f; // base elevation
-    float amp = 6.0f;  // amplitude
-    return base + n * amp; // final height
+    float fx = static_cast<float>(wx);
+    float fz = static_cast<float>(wz);
+    float n = (std::sin(fx * 0.12f + phaseX) + std::sin(fz * 0.08f + phaseZ) * 0.8f +
+               std::sin((fx + fz) * 0.05f + phaseXZ) * 0.5f) * 0.5f;
+    return BASE + n * AMP; // final height
 }
 
-void HeightmapGenerator::GenerateChunk(const ChunkCoord& coord, BlockId* outBlocks, int chunkSize) {
-    // Clear to air
-    int volume = chunkSize * chunkSize * chunkSize;
-    for (int i = 0; i < volume; ++i) outBlocks[i] = 0;
-
-    // For every x,z column in the chunk, sample world-space height and fill blocks below with dirt (id=1)
-    for (int lx = 0; lx < chunkSize; ++lx) {
-        for (int lz = 0; lz < chunkSize; ++lz) {
-            int wx = coord.x * chunkSize + lx;
-            int wz = coord.z * chunkSize + lz;
-            float h = SampleHeight(wx, wz);
-            int ih = static_cast<int>(std::floor(h));
-            for (int y = 0; y < chunkSize; ++y) {
-                int wy = coord.y * chunkSize + y;
-                if (wy <= ih) {
-                    int index = lx + lz * chunkSize + y * chunkSize * chunkSize;
-                    outBlocks[index] = 1; // dirt
-                }
+void HeightmapGenerator::SampleColumnHeights(int wx0, int wz0, int size, int* outHeights) const {
+    using namespace Simd;
+    const F8 laneOffset = { f32x4{ 0, 1, 2, 3 }, f32x4{ 4, 5, 6, 7 } };
+    int32_t tail[LANES];
+
+    for (int lz = 0; lz < size; ++lz) {
+        const F8 fz = Splat(static_cast<float>(wz0 + lz));
+        const F8 rowTerm = Sin(fz * 0.08f + phaseZ) * 0.8f;
+        int* row = outHeights + lz * size;
+
+        for (int lx = 0; lx < size; lx += LANES) {
+            F8 fx = laneOffset + static_cast<float>(wx0 + lx);
+            F8 n = (Sin(fx * 0.12f + phaseX) + rowTerm + Sin((fx + fz) * 0.05f + phaseXZ) * 0.5f) * 0.5f;
+            I8 h = ToInt(Floor(n * AMP + BASE));
+            if (lx + LANES <= size) {
+                StoreI(row + lx, h);
+            } else {
+                StoreI(tail, h);
+                std::copy(tail, tail + (size - lx), row + lx);
             }
         }
     }
 }
+
+void HeightmapGenerator::BuildColumn(int cx, int cz, int size, ColumnData& out) const {
+    const int area = size * size;
+    out.size = size;
+    out.heights.resize(area);
+    SampleColumnHeights(cx * size, cz * size, size, out.heights.data());
+    // Single biome and surface block until the generator grows more
+    out.biomes.assign(area, BIOME_PLAINS);
+    out.surface.assign(area, Blocks::DIRT);
+
+    out.minHeight = INT_MAX;
+    out.maxHeight = INT_MIN;
+    for (int h : out.heights) {
+        out.minHeight = std::min(out.minHeight, h);
+        out.maxHeight = std::max(out.maxHeight, h);
+    }
+}
+
+void HeightmapGenerator::FillFromColumn(const ColumnData& column, const ChunkCoord& coord, int chunkSize,
+                                        BlockId solid, BlockId* outBlocks) {
+    const int layer = chunkSize * chunkSize;
+    const std::vector<int>& heights = column.heights;
+    const int minH = column.minHeight;
+    const int maxH = column.maxHeight;
+
+    // Blocks are stored y-major, so each y layer is one contiguous run: layers
+    // entirely below or above the surface are single memsets; only layers the
+    // surface passes through are filled row by row
+    const int wy0 = coord.y * chunkSize;
+    for (int y = 0; y < chunkSize; ++y) {
+        const int wy = wy0 + y;
+        BlockId* dst = outBlocks + y * layer;
+        if (wy <= minH) {
+            std::memset(dst, solid, layer);
+        } else if (wy > maxH) {
+            std::memset(dst, Blocks::AIR, static_cast<size_t>(layer) * (chunkSize - y));
+            break;
+        } else {
+            for (int i = 0; i < layer; ++i) dst[i] = wy <= heights[i] ? solid : Blocks::AIR;
+        }
+    }
+}
+
+void HeightmapGenerator::GenerateChunk(const ChunkCoord& coord, BlockId* outBlocks, int chunkSize) {
+    // Every chunk in this column shares one height grid
+    auto column = columns.GetOrBuild(coord.x, coord.z, [&](int cx, int cz, ColumnData& out) {
+        BuildColumn(cx, cz, chunkSize, out);
+    });
+    FillFromColumn(*column, coord, chunkSize, Blocks::DIRT, outBlocks);
+}
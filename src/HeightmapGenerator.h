@@ -1,10 +1,33 @@
 #pragma once
 #include "WorldGenerator.h"
 
+// Sum-of-sines heightfield. The seed picks each term's phase. Chunks are
+// generated through the batch path, which uses only integer and basic float
+// arithmetic (no libm), so a seed gives the same terrain on every platform.
 class HeightmapGenerator : public WorldGenerator {
 public:
-    HeightmapGenerator();
+    explicit HeightmapGenerator(uint32_t seed = 0);
     virtual void GenerateChunk(const ChunkCoord& coord, BlockId* outBlocks, int chunkSize) override;
-private:
+
+    // Surface height (highest solid world y) of a size x size grid of columns
+    // starting at (wx0, wz0), eight columns at a time. out[lx + lz * size]
+    void SampleColumnHeights(int wx0, int wz0, int size, int* outHeights) const;
+
+    // Scalar reference for one column (std::sin; the batch path uses a polynomial)
     float SampleHeight(int wx, int wz) const;
+
+    // Column data for chunk column (cx, cz): heights, biome and surface block
+    void BuildColumn(int cx, int cz, int size, ColumnData& out) const;
+
+    // Fill a chunk with `solid` up to the column heights and air above
+    static void FillFromColumn(const ColumnData& column, const ChunkCoord& coord, int chunkSize,
+                               BlockId solid, BlockId* outBlocks);
+
+    uint32_t GetSeed() const { return seed; }
+
+private:
+    uint32_t seed;
+    float phaseX;
+    float phaseZ;
+    float phaseXZ;
 };
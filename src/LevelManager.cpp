@@ -81,7 +81,8 @@ std::vector<ChunkPath> LevelManager::GetChildren(const ChunkPath& parent) const
         for (int y = 0; y < 2; ++y) {
             for (int z = 0; z < 2; ++z) {
                 ChunkPath child = parent;
-                child.Append(x * 4, y * 4, z * 4);  // Use corners of octant
+                // Octant corners within the step's range (x,y: -4..3, z: -2..1)
+                child.Append(x * 4 - 4, y * 4 - 4, z * 2 - 2);
                 children.push_back(child);
             }
         }
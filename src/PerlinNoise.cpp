@@ -1,20 +1,116 @@
 #include "PerlinNoise.h"
+#include "SimdMath.h"
+#include "Random.h"
 #include <algorithm>
-#include <random>
+#include <cmath>
 
-PerlinNoise::PerlinNoise(unsigned int seed) {
-    // Initialize permutation table
-    p.resize(256);
-    for (int i = 0; i < 256; ++i) {
-        p[i] = i;
+namespace {
+    using namespace Simd;
+    typedef uint32_t u32x4 __attribute__((vector_size(16)));
+
+    // Offsets of the two warp lookups; arbitrary, just far apart
+    const float WARP_AX = 5.2f, WARP_AY = 1.3f;
+    const float WARP_BX = 1.7f, WARP_BY = 9.2f;
+
+    inline uint32_t OctaveSeed(uint32_t seed, int octave) {
+        return seed + static_cast<uint32_t>(octave) * 0x9E3779B9u;
+    }
+
+    // Four lanes of Random::Hash (the scalar lattice hash); must stay bit-identical to it
+    inline u32x4 Hash4(i32x4 x, i32x4 y, i32x4 z, uint32_t seed) {
+        u32x4 h = u32x4{} + seed;
+        h ^= (u32x4)x * 0x8DA6B343u;
+        h ^= (u32x4)y * 0xD8163841u;
+        h ^= (u32x4)z * 0xCB1AB31Fu;
+        h = (h ^ (h >> 16)) * 0x7FEB352Du;
+        h = (h ^ (h >> 15)) * 0x846CA68Bu;
+        return h ^ (h >> 16);
+    }
+
+    inline I8 Hash8(const I8& x, const I8& y, const I8& z, uint32_t seed) {
+        return { (i32x4)Hash4(x.lo, y.lo, z.lo, seed), (i32x4)Hash4(x.hi, y.hi, z.hi, seed) };
+    }
+
+    // Improved-noise gradient set picked with lane masks instead of a table
+    inline F8 Grad8(const I8& hash, const F8& x, const F8& y, const F8& z) {
+        I8 h = hash & 15;
+        F8 u = Select(h < 8, x, y);
+        F8 v = Select(h < 4, y, Select((h == 12) | (h == 14), x, z));
+        return NegateOdd(u, h) + NegateOdd(v, h >> 1);
+    }
+
+    inline F8 Fade8(const F8& t) {
+        return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+    }
+
+    inline F8 Lerp8(const F8& t, const F8& a, const F8& b) {
+        return a + t * (b - a);
+    }
+
+    F8 Perlin8(F8 x, F8 y, uint32_t seed) {
+        F8 fx = Floor(x), fy = Floor(y);
+        I8 X = ToInt(fx), Y = ToInt(fy);
+        I8 zero = SplatI(0);
+        x = x - fx;
+        y = y - fy;
+        F8 u = Fade8(x), v = Fade8(y);
+        F8 x1 = x - 1.0f, y1 = y - 1.0f, z = Splat(0.0f);
+
+        F8 res = Lerp8(v,
+            Lerp8(u, Grad8(Hash8(X, Y, zero, seed), x, y, z), Grad8(Hash8(X + 1, Y, zero, seed), x1, y, z)),
+            Lerp8(u, Grad8(Hash8(X, Y + 1, zero, seed), x, y1, z), Grad8(Hash8(X + 1, Y + 1, zero, seed), x1, y1, z)));
+        return (res + 1.0f) * 0.5f;
+    }
+
+    F8 Perlin8(F8 x, F8 y, F8 z, uint32_t seed) {
+        F8 fx = Floor(x), fy = Floor(y), fz = Floor(z);
+        I8 X = ToInt(fx), Y = ToInt(fy), Z = ToInt(fz);
+        x = x - fx;
+        y = y - fy;
+        z = z - fz;
+        F8 u = Fade8(x), v = Fade8(y), w = Fade8(z);
+        F8 x1 = x - 1.0f, y1 = y - 1.0f, z1 = z - 1.0f;
+        I8 X1 = X + 1, Y1 = Y + 1, Z1 = Z + 1;
+
+        F8 near = Lerp8(v,
+            Lerp8(u, Grad8(Hash8(X, Y, Z, seed), x, y, z), Grad8(Hash8(X1, Y, Z, seed), x1, y, z)),
+            Lerp8(u, Grad8(Hash8(X, Y1, Z, seed), x, y1, z), Grad8(Hash8(X1, Y1, Z, seed), x1, y1, z)));
+        F8 far = Lerp8(v,
+            Lerp8(u, Grad8(Hash8(X, Y, Z1, seed), x, y, z1), Grad8(Hash8(X1, Y, Z1, seed), x1, y, z1)),
+            Lerp8(u, Grad8(Hash8(X, Y1, Z1, seed), x, y1, z1), Grad8(Hash8(X1, Y1, Z1, seed), x1, y1, z1)));
+        return (Lerp8(w, near, far) + 1.0f) * 0.5f;
+    }
+
+    template <typename Sample>
+    F8 Octaves8(int octaves, float persistence, uint32_t seed, const Sample& sample) {
+        F8 value = Splat(0.0f);
+        float amplitude = 1.0f, frequency = 1.0f, maxValue = 0.0f;
+        for (int i = 0; i < octaves; ++i) {
+            value = value + sample(frequency, OctaveSeed(seed, i)) * amplitude;
+            maxValue += amplitude;
+            amplitude *= persistence;
+            frequency *= 2.0f;
+        }
+        return value * (1.0f / (maxValue > 0.0f ? maxValue : 1.0f));
     }
 
-    // Shuffle with seed
-    std::mt19937 gen(seed);
-    std::shuffle(p.begin(), p.end(), gen);
+    // Store a batch, clipping the last one of a row
+    inline void StoreRow(float* dst, int remaining, const F8& v) {
+        if (remaining >= LANES) {
+            Store(dst, v);
+            return;
+        }
+        float tmp[LANES];
+        Store(tmp, v);
+        std::copy(tmp, tmp + remaining, dst);
+    }
+
+    const F8 LANE_INDEX = { f32x4{ 0, 1, 2, 3 }, f32x4{ 4, 5, 6, 7 } };
+}
 
-    // Duplicate for overflow
-    p.insert(p.end(), p.begin(), p.end());
+PerlinNoise::PerlinNoise(unsigned int seed) {
+    // Scramble the seed so nearby seeds give unrelated fields
+    this->seed = Random::Hash(0x9E3779B9u, static_cast<int32_t>(seed), 0x51ED, 0x2A17);
 }
 
 double PerlinNoise::fade(double t) const {
@@ -25,10 +121,10 @@ double PerlinNoise::lerp(double t, double a, double b) const {
     return a + t * (b - a);
 }
 
-double PerlinNoise::grad(int hash, double x, double y) const {
+double PerlinNoise::grad(uint32_t hash, double x, double y, double z) const {
     int h = hash & 15;
     double u = h < 8 ? x : y;
-    double v = h < 4 ? y : (h == 12 || h == 14 ? x : 0);
+    double v = h < 4 ? y : (h == 12 || h == 14 ? x : z);
     return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
 }
 
@@ -39,7 +135,23 @@ double PerlinNoise::noise(double x, double y, int octaves, double persistence) c
     double maxValue = 0.0;
 
     for (int i = 0; i < octaves; ++i) {
-        value += perlinNoise(x * frequency, y * frequency) * amplitude;
+        value += perlinNoise(x * frequency, y * frequency, OctaveSeed(seed, i)) * amplitude;
+        maxValue += amplitude;
+        amplitude *= persistence;
+        frequency *= 2.0;
+    }
+
+    return value / maxValue;
+}
+
+double PerlinNoise::noise3(double x, double y, double z, int octaves, double persistence) const {
+    double value = 0.0;
+    double amplitude = 1.0;
+    double frequency = 1.0;
+    double maxValue = 0.0;
+
+    for (int i = 0; i < octaves; ++i) {
+        value += perlinNoise3(x * frequency, y * frequency, z * frequency, OctaveSeed(seed, i)) * amplitude;
         maxValue += amplitude;
         amplitude *= persistence;
         frequency *= 2.0;
@@ -48,31 +160,94 @@ double PerlinNoise::noise(double x, double y, int octaves, double persistence) c
     return value / maxValue;
 }
 
-double PerlinNoise::perlinNoise(double x, double y) const {
+double PerlinNoise::warpedNoise(double x, double y, double warp, int octaves, double persistence) const {
+    // Warp offsets in [-warp, warp]
+    double qx = noise(x + WARP_AX, y + WARP_AY, octaves, persistence) * 2.0 - 1.0;
+    double qy = noise(x + WARP_BX, y + WARP_BY, octaves, persistence) * 2.0 - 1.0;
+    return noise(x + warp * qx, y + warp * qy, octaves, persistence);
+}
+
+double PerlinNoise::perlinNoise(double x, double y, uint32_t octaveSeed) const {
     // Find unit square
-    int X = (int)std::floor(x) & 255;
-    int Y = (int)std::floor(y) & 255;
+    double fx = std::floor(x);
+    double fy = std::floor(y);
+    int X = static_cast<int>(fx);
+    int Y = static_cast<int>(fy);
 
     // Find relative x,y in square
-    x -= std::floor(x);
-    y -= std::floor(y);
+    x -= fx;
+    y -= fy;
 
     // Compute fade curves
     double u = fade(x);
     double v = fade(y);
 
-    // Hash coordinates
-    int A = p[X] + Y;
-    int AA = p[A];
-    int AB = p[A + 1];
-    int B = p[X + 1] + Y;
-    int BA = p[B];
-    int BB = p[B + 1];
-
     // Add blended results from 4 corners
     double res = lerp(v,
-        lerp(u, grad(p[AA], x, y), grad(p[BA], x - 1, y)),
-        lerp(u, grad(p[AB], x, y - 1), grad(p[BB], x - 1, y - 1)));
+        lerp(u, grad(Random::Hash(octaveSeed, X, Y, 0), x, y, 0), grad(Random::Hash(octaveSeed, X + 1, Y, 0), x - 1, y, 0)),
+        lerp(u, grad(Random::Hash(octaveSeed, X, Y + 1, 0), x, y - 1, 0), grad(Random::Hash(octaveSeed, X + 1, Y + 1, 0), x - 1, y - 1, 0)));
 
     return (res + 1.0) / 2.0; // Normalize to [0,1]
-}
\ No newline at end of file
+}
+
+double PerlinNoise::perlinNoise3(double x, double y, double z, uint32_t octaveSeed) const {
+    double fx = std::floor(x), fy = std::floor(y), fz = std::floor(z);
+    int X = static_cast<int>(fx), Y = static_cast<int>(fy), Z = static_cast<int>(fz);
+    x -= fx;
+    y -= fy;
+    z -= fz;
+    double u = fade(x), v = fade(y), w = fade(z);
+
+    double nearRes = lerp(v,
+        lerp(u, grad(Random::Hash(octaveSeed, X, Y, Z), x, y, z), grad(Random::Hash(octaveSeed, X + 1, Y, Z), x - 1, y, z)),
+        lerp(u, grad(Random::Hash(octaveSeed, X, Y + 1, Z), x, y - 1, z), grad(Random::Hash(octaveSeed, X + 1, Y + 1, Z), x - 1, y - 1, z)));
+    double farRes = lerp(v,
+        lerp(u, grad(Random::Hash(octaveSeed, X, Y, Z + 1), x, y, z - 1), grad(Random::Hash(octaveSeed, X + 1, Y, Z + 1), x - 1, y, z - 1)),
+        lerp(u, grad(Random::Hash(octaveSeed, X, Y + 1, Z + 1), x, y - 1, z - 1), grad(Random::Hash(octaveSeed, X + 1, Y + 1, Z + 1), x - 1, y - 1, z - 1)));
+
+    return (lerp(w, nearRes, farRes) + 1.0) / 2.0;
+}
+
+void PerlinNoise::noiseGrid(float x0, float y0, float step, int countX, int countY, float* out,
+                            int octaves, float persistence) const {
+    for (int j = 0; j < countY; ++j) {
+        const F8 y = Splat(y0 + static_cast<float>(j) * step);
+        for (int i = 0; i < countX; i += LANES) {
+            const F8 x = (LANE_INDEX + static_cast<float>(i)) * step + x0;
+            F8 v = Octaves8(octaves, persistence, seed, [&](float f, uint32_t s) { return Perlin8(x * f, y * f, s); });
+            StoreRow(out + j * countX + i, countX - i, v);
+        }
+    }
+}
+
+void PerlinNoise::noiseGrid3(float x0, float y0, float z0, float step, int countX, int countY, int countZ, float* out,
+                             int octaves, float persistence) const {
+    for (int j = 0; j < countY; ++j) {
+        const F8 y = Splat(y0 + static_cast<float>(j) * step);
+        for (int k = 0; k < countZ; ++k) {
+            const F8 z = Splat(z0 + static_cast<float>(k) * step);
+            float* row = out + k * countX + j * countX * countZ;
+            for (int i = 0; i < countX; i += LANES) {
+                const F8 x = (LANE_INDEX + static_cast<float>(i)) * step + x0;
+                F8 v = Octaves8(octaves, persistence, seed, [&](float f, uint32_t s) { return Perlin8(x * f, y * f, z * f, s); });
+                StoreRow(row + i, countX - i, v);
+            }
+        }
+    }
+}
+
+void PerlinNoise::warpedNoiseGrid(float x0, float y0, float step, int countX, int countY, float warp, float* out,
+                                  int octaves, float persistence) const {
+    for (int j = 0; j < countY; ++j) {
+        const F8 y = Splat(y0 + static_cast<float>(j) * step);
+        for (int i = 0; i < countX; i += LANES) {
+            const F8 x = (LANE_INDEX + static_cast<float>(i)) * step + x0;
+            auto octavesAt = [&](const F8& px, const F8& py) {
+                return Octaves8(octaves, persistence, seed, [&](float f, uint32_t s) { return Perlin8(px * f, py * f, s); });
+            };
+            F8 qx = octavesAt(x + WARP_AX, y + WARP_AY) * 2.0f - 1.0f;
+            F8 qy = octavesAt(x + WARP_BX, y + WARP_BY) * 2.0f - 1.0f;
+            StoreRow(out + j * countX + i, countX - i, octavesAt(x + qx * warp, y + qy * warp));
+        }
+    }
+}
@@ -1,8 +1,13 @@
 #pragma once
-#include <vector>
-#include <cmath>
+#include <cstdint>
 
-// Simple Perlin noise implementation for terrain generation
+// Simple Perlin noise implementation for terrain generation.
+//
+// Lattice gradients come from an integer hash of the cell coordinates and the
+// seed rather than a permutation table, so the batch functions evaluate eight
+// samples at once with no table gathers. Scalar and batch paths share the hash
+// and gradient set; the batch path runs in float and matches the scalar one
+// to within float precision. Outputs are in [0,1].
 class PerlinNoise {
 public:
     PerlinNoise(unsigned int seed = 0);
@@ -10,12 +15,27 @@ public:
 
     // Generate noise value at (x, y) with given octaves and persistence
     double noise(double x, double y, int octaves = 4, double persistence = 0.5) const;
+    double noise3(double x, double y, double z, int octaves = 4, double persistence = 0.5) const;
+    // Noise sampled at a point displaced by two further noise lookups (domain warp)
+    double warpedNoise(double x, double y, double warp, int octaves = 4, double persistence = 0.5) const;
+
+    // Batch versions over regular grids starting at the origin with the given spacing.
+    // 2D: out[i + j * countX] samples (x0 + i*step, y0 + j*step), e.g. a chunk's XZ column grid.
+    void noiseGrid(float x0, float y0, float step, int countX, int countY, float* out,
+                   int octaves = 4, float persistence = 0.5f) const;
+    // 3D, in chunk block order: out[i + k * countX + j * countX * countZ] samples
+    // (x0 + i*step, y0 + j*step, z0 + k*step)
+    void noiseGrid3(float x0, float y0, float z0, float step, int countX, int countY, int countZ, float* out,
+                    int octaves = 4, float persistence = 0.5f) const;
+    void warpedNoiseGrid(float x0, float y0, float step, int countX, int countY, float warp, float* out,
+                         int octaves = 4, float persistence = 0.5f) const;
 
 private:
-    std::vector<int> p; // Permutation table
+    uint32_t seed;
 
     double fade(double t) const;
     double lerp(double t, double a, double b) const;
-    double grad(int hash, double x, double y) const;
-    double perlinNoise(double x, double y) const;
-};
\ No newline at end of file
+    double grad(uint32_t hash, double x, double y, double z) const;
+    double perlinNoise(double x, double y, uint32_t octaveSeed) const;
+    double perlinNoise3(double x, double y, double z, uint32_t octaveSeed) const;
+};
@@ -1,20 +1,151 @@
 #include "PhysicsSystem.h"
+#include "Chunk.h"
+#include "ChunkManager.h"
+#include <climits>
+#include <cmath>
 
-// Update position of entities based on their velocity
-void PhysicsSystem::Update  (std::vector<Entity>& entities, float dt) {
-    for (auto& entity : entities) {
-        if (entity.is_active) {
-            entity.position.x += entity.velocity.x * dt;
-            entity.position.y += entity.velocity.y * dt;
-            entity.position.z += entity.velocity.z * dt;
-            
-            // Update bounding box position
-            entity.bounds.min.x = entity.position.x - 0.5f;
-            entity.bounds.min.y = entity.position.y - 0.5f;
-            entity.bounds.min.z = entity.position.z - 0.5f;
-            entity.bounds.max.x = entity.position.x + 0.5f;
-            entity.bounds.max.y = entity.position.y + 0.5f;
-            entity.bounds.max.z = entity.position.z + 0.5f;
+namespace {
+    constexpr int S = Chunk::SIZE;
+    // Gap left between a stopped box and the block face, so rounding can't put
+    // it inside the block on the next step
+    constexpr float SKIN = 1e-4f;
+
+    int ChunkOf(int block) {
+        return (block >= 0 ? block : block - (S - 1)) / S;
+    }
+
+    // Solid-block lookups reading chunk block arrays directly. Remembers the last
+    // chunk it looked up, so the few cells around an entity usually cost a
+    // coordinate compare rather than a store lookup.
+    class TerrainProbe {
+    public:
+        explicit TerrainProbe(const ChunkStore& store) : store(store) {}
+
+        // Start from a collider's remembered chunk, if that is still resident
+        void Use(const TerrainCollider& c) {
+            const ChunkStore::Ref ref{ c.chunkIndex, c.chunkSerial };
+            if (const Chunk* chunk = store.Resolve(ref)) {
+                last = chunk;
+                lastRef = ref;
+                lastX = c.cx;
+                lastY = c.cy;
+                lastZ = c.cz;
+            }
+        }
+
+        const Chunk* ChunkAt(int cx, int cy, int cz) {
+            if (cx != lastX || cy != lastY || cz != lastZ) {
+                lastRef = ChunkStore::Ref{};
+                last = store.Find(cx, cy, cz, lastRef);
+                lastX = cx;
+                lastY = cy;
+                lastZ = cz;
+            }
+            return last;
+        }
+
+        // Ref for the chunk ChunkAt last returned (stale when there was none)
+        const ChunkStore::Ref& LastRef() const { return lastRef; }
+
+        bool IsSolid(int x, int y, int z) {
+            const int cx = ChunkOf(x), cy = ChunkOf(y), cz = ChunkOf(z);
+            const Chunk* chunk = ChunkAt(cx, cy, cz);
+            // Chunks that aren't resident have no terrain to hit
+            if (!chunk) return false;
+            return chunk->Data()[(x - cx * S) + (z - cz * S) * S + (y - cy * S) * S * S] != 0;
+        }
+
+    private:
+        const ChunkStore& store;
+        const Chunk* last = nullptr;
+        ChunkStore::Ref lastRef;
+        int lastX = INT_MIN, lastY = INT_MIN, lastZ = INT_MIN;
+    };
+
+    // Distance `box` can move along `axis` (0..2) towards `delta` before its
+    // leading face reaches a solid block. Blocks it already overlaps are ignored,
+    // so an entity spawned inside terrain can still move out.
+    float SweepAxis(TerrainProbe& probe, const BoundingBox& box, int axis, float delta) {
+        if (delta == 0.0f) return 0.0f;
+        const int u = (axis + 1) % 3;
+        const int w = (axis + 2) % 3;
+        const float* lo = &box.min.x;
+        const float* hi = &box.max.x;
+        // Cells the box covers across the sweep; a face lying on a block boundary doesn't count
+        const int u0 = static_cast<int>(std::floor(lo[u])), u1 = static_cast<int>(std::ceil(hi[u])) - 1;
+        const int w0 = static_cast<int>(std::floor(lo[w])), w1 = static_cast<int>(std::ceil(hi[w])) - 1;
+
+        int cell[3];
+        auto layerSolid = [&](int layer) {
+            cell[axis] = layer;
+            for (int a = u0; a <= u1; ++a)
+                for (int b = w0; b <= w1; ++b) {
+                    cell[u] = a;
+                    cell[w] = b;
+                    if (probe.IsSolid(cell[0], cell[1], cell[2])) return true;
+                }
+            return false;
+        };
+
+        if (delta > 0.0f) {
+            const int last = static_cast<int>(std::ceil(hi[axis] + delta)) - 1;
+            for (int layer = static_cast<int>(std::ceil(hi[axis])); layer <= last; ++layer) {
+                if (layerSolid(layer)) return std::fmax(0.0f, layer - hi[axis] - SKIN);
+            }
+        } else {
+            const int last = static_cast<int>(std::floor(lo[axis] + delta));
+            for (int layer = static_cast<int>(std::floor(lo[axis])) - 1; layer >= last; --layer) {
+                if (layerSolid(layer)) return std::fmin(0.0f, layer + 1 - lo[axis] + SKIN);
+            }
         }
+        return delta;
     }
-}  
+}
+
+// Update position of entities based on their velocity
+void PhysicsSystem::Update(EntityWorld& world, float dt) {
+    // Position and Velocity are three packed floats, so each block's columns are
+    // plain float arrays here and the integration is one straight, vectorizable loop
+    moving.ForEachBlock(world, [dt](size_t count, const EntityHandle*, Position* positions, const Velocity* velocities) {
+        float* pos = &positions[0].x;
+        const float* vel = &velocities[0].x;
+        for (size_t i = 0; i < count * 3; ++i) {
+            pos[i] += vel[i] * dt;
+        }
+    });
+
+    // Terrain colliders move one axis at a time, vertical first so resting
+    // entities slide along the ground; a blocked axis loses its velocity
+    const ChunkStore& store = ChunkManager::GetStore();
+    TerrainProbe probe(store);
+    colliding.ForEachBlock(world, [&](size_t count, const EntityHandle*, Position* positions, Velocity* velocities,
+                                      TerrainCollider* colliders) {
+        for (size_t i = 0; i < count; ++i) {
+            TerrainCollider& c = colliders[i];
+            probe.Use(c);
+
+            float* pos = &positions[i].x;
+            float* vel = &velocities[i].x;
+            for (int axis : { 1, 0, 2 }) {
+                const float delta = vel[axis] * dt;
+                const float moved = SweepAxis(probe, BoundsAround(positions[i]), axis, delta);
+                if (moved != delta) vel[axis] = 0.0f;
+                pos[axis] += moved;
+            }
+
+            c.cx = ChunkOf(static_cast<int>(std::floor(pos[0])));
+            c.cy = ChunkOf(static_cast<int>(std::floor(pos[1])));
+            c.cz = ChunkOf(static_cast<int>(std::floor(pos[2])));
+            probe.ChunkAt(c.cx, c.cy, c.cz);
+            c.chunkIndex = probe.LastRef().index;
+            c.chunkSerial = probe.LastRef().serial;
+        }
+    });
+
+    // Update bounding box position
+    bounded.ForEachBlock(world, [](size_t count, const EntityHandle*, const Position* p, Bounds* bounds) {
+        for (size_t i = 0; i < count; ++i) {
+            bounds[i] = BoundsAround(p[i]);
+        }
+    });
+}
@@ -1,9 +1,14 @@
 #pragma once
-#include <vector>
 #include "Entity.h"
 
-// Movin' 
+// Movin'. Entities with a TerrainCollider are swept against the solid blocks of
+// resident chunks one axis at a time and stop where they would enter one.
 class PhysicsSystem {
 public:
-    void Update(std::vector<Entity>& entities, float dt);
+    void Update(EntityWorld& world, float dt);
+
+private:
+    Query<Position, const Velocity> moving{ ComponentMaskOf<TerrainCollider>() };
+    Query<Position, Velocity, TerrainCollider> colliding;
+    Query<const Position, Bounds> bounded;
 };
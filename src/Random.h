@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Portable, fully specified random numbers for world generation. <random>
+// distributions (and std::shuffle) are implementation-defined, so the same
+// seed can give different worlds with different standard libraries; these are
+// plain integer arithmetic and produce identical sequences everywhere.
+namespace Random {
+    // Mix a seed and integer coordinates into a well-distributed 32-bit value
+    inline uint32_t Hash(uint32_t seed, int x, int y, int z) {
+        uint32_t h = seed ^ (static_cast<uint32_t>(x) * 0x8DA6B343u) ^ (static_cast<uint32_t>(y) * 0xD8163841u) ^
+                     (static_cast<uint32_t>(z) * 0xCB1AB31Fu);
+        h ^= h >> 16; h *= 0x7FEB352Du;
+        h ^= h >> 15; h *= 0x846CA68Bu;
+        h ^= h >> 16;
+        return h;
+    }
+
+    // World seed from config text: decimal numbers are used as-is, any other
+    // text is hashed (FNV-1a), so "guana" is as valid a seed as 1234
+    inline uint32_t SeedFromString(const std::string& text) {
+        if (!text.empty() && text.size() <= 10 && text.find_first_not_of("0123456789") == std::string::npos) {
+            uint64_t v = std::stoull(text);
+            if (v <= 0xFFFFFFFFull) return static_cast<uint32_t>(v);
+        }
+        uint32_t h = 2166136261u;
+        for (unsigned char c : text) {
+            h ^= c;
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    // PCG32 (O'Neill, pcg32_random_r): 64-bit state, 32-bit output
+    class Pcg32 {
+    public:
+        explicit Pcg32(uint64_t seed, uint64_t stream = 0xDA3E39CB94B95BDBull) : state(0), inc((stream << 1) | 1u) {
+            Next();
+            state += seed;
+            Next();
+        }
+
+        uint32_t Next() {
+            uint64_t old = state;
+            state = old * 6364136223846793005ull + inc;
+            uint32_t xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+            uint32_t rot = static_cast<uint32_t>(old >> 59);
+            return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+        }
+
+        // Uniform in [0, bound), by rejection rather than a biased modulo
+        uint32_t Below(uint32_t bound) {
+            uint32_t threshold = (0u - bound) % bound;
+            for (;;) {
+                uint32_t r = Next();
+                if (r >= threshold) return r % bound;
+            }
+        }
+
+        int Range(int n) { return static_cast<int>(Below(static_cast<uint32_t>(n))); }
+
+    private:
+        uint64_t state;
+        uint64_t inc;
+    };
+}
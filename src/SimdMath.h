@@ -0,0 +1,96 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+// Portable 8-lane float math for batch generators.
+//
+// An F8 is two 4-wide GCC/Clang vectors. Each half maps straight onto one SSE
+// or NEON register, so this vectorizes at any optimization level and needs
+// no -mavx (a single 32-byte vector type would change the calling convention).
+namespace Simd {
+    typedef float f32x4 __attribute__((vector_size(16)));
+    typedef int32_t i32x4 __attribute__((vector_size(16)));
+
+    constexpr int LANES = 8;
+
+    struct F8 { f32x4 lo, hi; };
+    struct I8 { i32x4 lo, hi; }; // integers, or lane masks (all ones = true) from comparisons
+
+    inline F8 Splat(float v) { return { f32x4{} + v, f32x4{} + v }; }
+    inline I8 SplatI(int32_t v) { return { i32x4{} + v, i32x4{} + v }; }
+
+    inline F8 Load(const float* p) { F8 r; std::memcpy(&r, p, sizeof(r)); return r; }
+    inline void Store(float* p, const F8& v) { std::memcpy(p, &v, sizeof(v)); }
+    inline I8 LoadI(const int32_t* p) { I8 r; std::memcpy(&r, p, sizeof(r)); return r; }
+    inline void StoreI(int32_t* p, const I8& v) { std::memcpy(p, &v, sizeof(v)); }
+
+    inline F8 operator+(const F8& a, const F8& b) { return { a.lo + b.lo, a.hi + b.hi }; }
+    inline F8 operator-(const F8& a, const F8& b) { return { a.lo - b.lo, a.hi - b.hi }; }
+    inline F8 operator*(const F8& a, const F8& b) { return { a.lo * b.lo, a.hi * b.hi }; }
+    inline F8 operator+(const F8& a, float b) { return { a.lo + b, a.hi + b }; }
+    inline F8 operator-(const F8& a, float b) { return { a.lo - b, a.hi - b }; }
+    inline F8 operator*(const F8& a, float b) { return { a.lo * b, a.hi * b }; }
+
+    inline F8 operator-(const F8& a) { return { -a.lo, -a.hi }; }
+
+    inline I8 operator+(const I8& a, const I8& b) { return { a.lo + b.lo, a.hi + b.hi }; }
+    inline I8 operator+(const I8& a, int32_t b) { return { a.lo + b, a.hi + b }; }
+    inline I8 operator&(const I8& a, const I8& b) { return { a.lo & b.lo, a.hi & b.hi }; }
+    inline I8 operator&(const I8& a, int32_t b) { return { a.lo & b, a.hi & b }; }
+    inline I8 operator|(const I8& a, const I8& b) { return { a.lo | b.lo, a.hi | b.hi }; }
+    inline I8 operator>>(const I8& a, int b) { return { a.lo >> b, a.hi >> b }; }
+    inline I8 operator<(const I8& a, int32_t b) { return { a.lo < b, a.hi < b }; }
+    inline I8 operator==(const I8& a, int32_t b) { return { a.lo == b, a.hi == b }; }
+
+    inline F8 ToFloat(const I8& v) { return { __builtin_convertvector(v.lo, f32x4), __builtin_convertvector(v.hi, f32x4) }; }
+    // Truncates toward zero
+    inline I8 ToInt(const F8& v) { return { __builtin_convertvector(v.lo, i32x4), __builtin_convertvector(v.hi, i32x4) }; }
+
+    inline I8 operator<(const F8& a, const F8& b) { return { a.lo < b.lo, a.hi < b.hi }; }
+    inline I8 operator>(const F8& a, const F8& b) { return { a.lo > b.lo, a.hi > b.hi }; }
+
+    // mask ? a : b, lane by lane
+    inline F8 Select(const I8& mask, const F8& a, const F8& b) {
+        F8 r;
+        r.lo = (f32x4)(((i32x4)a.lo & mask.lo) | ((i32x4)b.lo & ~mask.lo));
+        r.hi = (f32x4)(((i32x4)a.hi & mask.hi) | ((i32x4)b.hi & ~mask.hi));
+        return r;
+    }
+
+    // Flip the sign of lanes where bit 0 of flip is set
+    inline F8 NegateOdd(const F8& v, const I8& flip) {
+        F8 r;
+        r.lo = (f32x4)((i32x4)v.lo ^ ((flip.lo & 1) << 31));
+        r.hi = (f32x4)((i32x4)v.hi ^ ((flip.hi & 1) << 31));
+        return r;
+    }
+
+    // Round to nearest via the 1.5*2^23 trick; exact for |v| < 2^22
+    inline F8 Round(const F8& v) {
+        const float magic = 12582912.0f;
+        F8 t = v + magic;
+        return t - magic;
+    }
+
+    inline F8 Floor(const F8& v) {
+        F8 r = Round(v);
+        // Comparison lanes are -1 where rounding went up
+        return r + ToFloat(r > v);
+    }
+
+    // sin(x) within ~1e-6 absolute for |x| < 65536 (degrades beyond): reduce to [-pi/2, pi/2], then an odd degree-9 polynomial
+    inline F8 Sin(const F8& x) {
+        F8 q = Round(x * 0.31830988618f);
+        // Cody-Waite split of pi keeps the reduction accurate for larger arguments
+        F8 r = x - q * 3.140625f;
+        r = r - q * 9.67502593994140625e-4f;
+        r = r - q * 1.509957990978376432e-7f;
+        F8 r2 = r * r;
+        F8 p = Splat(2.6019031e-6f);
+        p = p * r2 + -1.9807418e-4f;
+        p = p * r2 + 8.3330255e-3f;
+        p = p * r2 + -1.6666657e-1f;
+        F8 s = r + r * r2 * p;
+        return NegateOdd(s, ToInt(q));
+    }
+}
@@ -0,0 +1,110 @@
+#include "ThreadPool.h"
+#include "Log.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+ThreadPool& ThreadPool::GetInstance() {
+    static ThreadPool instance;
+    return instance;
+}
+
+void ThreadPool::Init(int threadCount) {
+    if (!workers.empty()) return;
+    if (threadCount <= 0) {
+        int hw = static_cast<int>(std::thread::hardware_concurrency());
+        threadCount = hw > 1 ? hw - 1 : 1;
+    }
+    stopping = false;
+    for (int i = 0; i < threadCount; ++i) {
+        workers.emplace_back([this] { WorkerLoop(); });
+    }
+    Log::Info("ThreadPool started with " + std::to_string(threadCount) + " workers");
+}
+
+void ThreadPool::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+    for (auto& t : workers) {
+        if (t.joinable()) t.join();
+    }
+    workers.clear();
+}
+
+void ThreadPool::Submit(std::function<void()> job) {
+    if (workers.empty()) {
+        job();
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+    jobAvailable.notify_one();
+}
+
+void ThreadPool::WaitIdle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return jobs.empty() && busy == 0; });
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& body) {
+    if (workers.empty() || count <= 1) {
+        for (size_t i = 0; i < count; ++i) body(i);
+        return;
+    }
+
+    // Shared with the helper jobs, which may only start after the caller has
+    // finished everything; they then find no index left and never touch body
+    struct Batch {
+        std::atomic<size_t> next{ 0 };
+        std::atomic<size_t> done{ 0 };
+        size_t count = 0;
+        const std::function<void(size_t)>* body = nullptr;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto batch = std::make_shared<Batch>();
+    batch->count = count;
+    batch->body = &body;
+
+    auto run = [batch] {
+        for (size_t i; (i = batch->next.fetch_add(1)) < batch->count;) {
+            (*batch->body)(i);
+            if (batch->done.fetch_add(1) + 1 == batch->count) {
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                batch->finished.notify_all();
+            }
+        }
+    };
+    const size_t helpers = std::min(workers.size(), count - 1);
+    for (size_t h = 0; h < helpers; ++h) Submit(run);
+    run();
+
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->finished.wait(lock, [&] { return batch->done.load() == batch->count; });
+}
+
+void ThreadPool::WorkerLoop() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+            // Drain the queue before honoring a stop request
+            if (jobs.empty()) return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+            ++busy;
+        }
+        job();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --busy;
+            if (jobs.empty() && busy == 0) idle.notify_all();
+        }
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads for background jobs (chunk generation, loading, ...)
+class ThreadPool {
+public:
+    static ThreadPool& GetInstance();
+
+    // Start the workers. threadCount <= 0 picks hardware_concurrency - 1 (at least 1).
+    void Init(int threadCount);
+    // Finish queued jobs and join the workers
+    void Shutdown();
+
+    // Queue a job. Runs inline when the pool has not been started.
+    void Submit(std::function<void()> job);
+    // Block until the queue is empty and no job is running
+    void WaitIdle();
+    // Run body(i) for every i in [0, count) on the workers and the calling
+    // thread, returning once all are done. The caller keeps taking indices
+    // itself, so it never waits behind unrelated queued jobs; with the pool
+    // busy or not started it just does more (or all) of the work.
+    void ParallelFor(size_t count, const std::function<void(size_t)>& body);
+
+    int GetThreadCount() const { return static_cast<int>(workers.size()); }
+
+private:
+    ThreadPool() {}
+    void WorkerLoop();
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable idle;
+    int busy = 0;
+    bool stopping = false;
+};
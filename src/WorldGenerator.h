@@ -1,10 +1,9 @@
 #pragma once
+#include "Blocks.h"
+#include "ColumnCache.h"
 
 // Minimal world generator interface used by Chunk/ChunkManager/HeightmapGenerator
 
-// Small integer type for blocks; 0 == air
-using BlockId = unsigned char;
-
 struct ChunkCoord {
     int x;
     int y;
@@ -16,4 +15,10 @@ public:
     virtual ~WorldGenerator() {}
     // Fill outBlocks (chunkSize^3 entries) for the chunk at coord
     virtual void GenerateChunk(const ChunkCoord& coord, BlockId* outBlocks, int chunkSize) = 0;
+
+    // 2D column data shared by vertically stacked chunks; the owner evicts it as the world streams
+    ColumnCache& GetColumnCache() { return columns; }
+
+protected:
+    ColumnCache columns;
 };